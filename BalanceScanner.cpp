@@ -0,0 +1,125 @@
+#include "BalanceScanner.h"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HW2_HAS_AVX2_KERNEL
+#endif
+
+namespace {
+    /**
+     * The columns of a block of sails.
+     */
+    struct SailsBlock {
+        const PortId* srcPorts;
+        const PortId* destPorts;
+        const int* startMinutes;
+        const int* endMinutes;
+        const int* containers;
+        size_t count;
+    };
+
+    /**
+     * Add the containers of the block's sails that arrive to / depart from a port until some time.
+     * @param block - the sails to scan.
+     * @param port - id of the port.
+     * @param minute - the time in minutes since the beginning of the year.
+     * @param volumes - (inbound, outbound) sums to add to.
+     */
+    using ScanKernel = void (*)(const SailsBlock& block, PortId port, int minute, pair<int, int>& volumes);
+
+    void scanScalar(const SailsBlock& block, PortId port, int minute, pair<int, int>& volumes) {
+        int inbound = 0;
+        int outbound = 0;
+        for (size_t i = 0; i < block.count; i++) {
+            // masks instead of branches, so the compiler can vectorize the loop
+            int arrives = -static_cast<int>(block.destPorts[i] == port && block.endMinutes[i] <= minute);
+            int departs = -static_cast<int>(block.srcPorts[i] == port && block.startMinutes[i] <= minute);
+            inbound += block.containers[i] & arrives;
+            outbound += block.containers[i] & departs;
+        }
+        volumes.first += inbound;
+        volumes.second += outbound;
+    }
+
+#ifdef HW2_HAS_AVX2_KERNEL
+    __attribute__((target("avx2")))
+    __m256i loadColumn(const void* column, size_t index) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(static_cast<const int*>(column) + index));
+    }
+
+    __attribute__((target("avx2")))
+    int horizontalSum(__m256i values) {
+        __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(values), _mm256_extracti128_si256(values, 1));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(sum);
+    }
+
+    __attribute__((target("avx2")))
+    void scanAvx2(const SailsBlock& block, PortId port, int minute, pair<int, int>& volumes) {
+        const __m256i ports = _mm256_set1_epi32(static_cast<int>(port));
+        const __m256i minutes = _mm256_set1_epi32(minute);
+        __m256i inbound = _mm256_setzero_si256();
+        __m256i outbound = _mm256_setzero_si256();
+
+        // 8 sails at a time
+        size_t i = 0;
+        for (; i + 8 <= block.count; i += 8) {
+            __m256i containers = loadColumn(block.containers, i);
+            // "end <= minute" is "not end > minute"
+            __m256i arrives = _mm256_andnot_si256(_mm256_cmpgt_epi32(loadColumn(block.endMinutes, i), minutes),
+                                                  _mm256_cmpeq_epi32(loadColumn(block.destPorts, i), ports));
+            __m256i departs = _mm256_andnot_si256(_mm256_cmpgt_epi32(loadColumn(block.startMinutes, i), minutes),
+                                                  _mm256_cmpeq_epi32(loadColumn(block.srcPorts, i), ports));
+            inbound = _mm256_add_epi32(inbound, _mm256_and_si256(arrives, containers));
+            outbound = _mm256_add_epi32(outbound, _mm256_and_si256(departs, containers));
+        }
+        volumes.first += horizontalSum(inbound);
+        volumes.second += horizontalSum(outbound);
+
+        // the sails that don't fill a whole vector
+        SailsBlock tail{block.srcPorts + i, block.destPorts + i, block.startMinutes + i, block.endMinutes + i,
+                        block.containers + i, block.count - i};
+        scanScalar(tail, port, minute, volumes);
+    }
+#endif
+
+    /**
+     * @return The fastest kernel the processor supports.
+     */
+    ScanKernel selectKernel() {
+#ifdef HW2_HAS_AVX2_KERNEL
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return scanAvx2;
+        }
+#endif
+        return scanScalar;
+    }
+
+    /**
+     * @return The kernel of the scans, chosen on the first call.
+     */
+    ScanKernel getKernel() {
+        static const ScanKernel kernel = selectKernel();
+        return kernel;
+    }
+}
+
+vector<pair<int, int>> BalanceScanner::scan(const ContainersSails &sails, const vector<pair<PortId, int>> &queries) {
+    ScanKernel scanKernel = getKernel();
+    vector<pair<int, int>> volumes(queries.size(), {0, 0});
+    for (size_t first = 0; first < sails.size(); first += BLOCK_SAILS) {
+        SailsBlock block{sails.getSrcPorts().data() + first, sails.getDestPorts().data() + first,
+                         sails.getStartMinutes().data() + first, sails.getEndMinutes().data() + first,
+                         sails.getContainers().data() + first, min(BLOCK_SAILS, sails.size() - first)};
+        // the block stays in the cache for all the queries
+        for (size_t i = 0; i < queries.size(); i++) {
+            scanKernel(block, queries[i].first, queries[i].second, volumes[i]);
+        }
+    }
+    return volumes;
+}
+
+bool BalanceScanner::usesAvx2() {
+    return getKernel() != scanScalar;
+}
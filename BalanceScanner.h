@@ -0,0 +1,40 @@
+#ifndef HW2_BALANCESCANNER_H
+#define HW2_BALANCESCANNER_H
+#include <iostream>
+#include <vector>
+#include "Port.h"
+#include "ContainersSails.h"
+using namespace std;
+
+/**
+ * A class that computes containers volumes by scanning the sails columns directly, without the ports timelines.
+ * The inbound volume of a port at some time is the sum of the containers of the sails that arrive to it until then,
+ * and the outbound volume is the sum of the containers of the sails that depart from it until then.
+ * The sails are scanned in blocks that stay in the cache while all the queries are evaluated over them,
+ * so a batch of queries reads the columns from memory once.
+ * The masked sums use AVX2 when the processor supports it, otherwise a scalar loop.
+ * Built only into the benchmark, as the baseline the timelines are measured against: a timeline answers a balance
+ * with a binary search, orders of magnitude faster than a scan, and the scan doesn't see the compacted sails.
+ */
+class BalanceScanner {
+private:
+    // amount of sails scanned for all the queries before moving to the next sails, 40KB of columns
+    static constexpr size_t BLOCK_SAILS = 2048;
+public:
+    /**
+     * Compute the inbound and outbound volumes of a batch of queries in one pass over the sails.
+     * @param sails - the containers graph's sails.
+     * @param queries - (port id, minute since the beginning of the year) of every query.
+     * @return (inbound, outbound) containers of every query, in the queries order.
+     * The balance of a query is its inbound minus its outbound.
+     */
+    static vector<pair<int, int>> scan(const ContainersSails& sails, const vector<pair<PortId, int>>& queries);
+
+    /**
+     * @return True if the scan uses the AVX2 kernel, false if it uses the scalar one.
+     */
+    static bool usesAvx2();
+};
+
+
+#endif //HW2_BALANCESCANNER_H
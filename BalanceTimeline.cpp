@@ -0,0 +1,62 @@
+#include "BalanceTimeline.h"
+#include <algorithm>
+
+void BalanceTimeline::flush() {
+    if (pendingEvents.empty()) {
+        return;
+    }
+
+    // merge the new events into the sorted ones
+    sort(pendingEvents.begin(), pendingEvents.end());
+    size_t oldSize = events.size();
+    events.insert(events.end(), pendingEvents.begin(), pendingEvents.end());
+    pendingEvents.clear();
+
+    // prefix sums are valid only up to the first event that moved
+    auto firstChanged = upper_bound(events.begin(), events.begin() + static_cast<long>(oldSize), events[oldSize]);
+    inplace_merge(events.begin(), events.begin() + static_cast<long>(oldSize), events.end());
+    size_t from = firstChanged - events.begin();
+
+    prefixBalance.resize(events.size());
+    prefixInbound.resize(events.size());
+    int runningBalance = from > 0 ? prefixBalance[from - 1] : 0;
+    int runningInbound = from > 0 ? prefixInbound[from - 1] : 0;
+    for (size_t i = from; i < events.size(); i++) {
+        runningBalance += events[i].second;
+        runningInbound += max(events[i].second, 0);
+        prefixBalance[i] = runningBalance;
+        prefixInbound[i] = runningInbound;
+    }
+}
+
+void BalanceTimeline::clearEvents() {
+    // move assigning an empty vector releases the memory, unlike clear
+    events = vector<pair<int, int>>();
+    prefixBalance = vector<int>();
+    prefixInbound = vector<int>();
+    pendingEvents = vector<pair<int, int>>();
+}
+
+size_t BalanceTimeline::eventsUntil(int minute) const {
+    // first event that occurred after the given time
+    auto after = upper_bound(events.begin(), events.end(), minute, [](int value, const pair<int, int>& event) {
+        return value < event.first;
+    });
+    return after - events.begin();
+}
+
+int BalanceTimeline::balanceAt(int minute) const {
+    size_t count = eventsUntil(minute);
+    if (count == 0) {
+        return baselineBalance;
+    }
+    return baselineBalance + prefixBalance[count - 1];
+}
+
+int BalanceTimeline::inboundAt(int minute) const {
+    size_t count = eventsUntil(minute);
+    if (count == 0) {
+        return baselineInbound;
+    }
+    return baselineInbound + prefixInbound[count - 1];
+}
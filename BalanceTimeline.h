@@ -0,0 +1,94 @@
+#ifndef HW2_BALANCETIMELINE_H
+#define HW2_BALANCETIMELINE_H
+#include <iostream>
+#include <vector>
+using namespace std;
+
+/**
+ * A class that represent the containers timeline of a single port.
+ * Every sail adds an event to the timeline of its ports (+containers when arriving to the destination port,
+ * -containers when departing from the source port). The events are kept sorted by time with a prefix sum of
+ * their containers, so the balance (and the inbound / outbound volume) at some time is a binary search.
+ * Events that were folded by a compaction are kept only as a baseline, which is added to every result.
+ */
+class BalanceTimeline {
+private:
+    // (minute, containers delta) events sorted by minute
+    vector<pair<int, int>> events;
+    // prefixBalance[i] is the sum of the deltas of events[0..i]
+    vector<int> prefixBalance;
+    // prefixInbound[i] is the sum of the positive deltas of events[0..i]
+    vector<int> prefixInbound;
+    // events added since the last flush, not sorted yet
+    vector<pair<int, int>> pendingEvents;
+    // sums of the deltas and of the positive deltas of the folded events
+    int baselineBalance = 0;
+    int baselineInbound = 0;
+
+    /**
+     * @param minute - the time in minutes since the beginning of the year.
+     * @return Amount of the flushed events that occurred at or before the given time.
+     */
+    size_t eventsUntil(int minute) const;
+public:
+    /**
+     * Add a containers event to the timeline.
+     * The event is visible to balanceAt only after the next flush.
+     * @param minute - the time of the event in minutes since the beginning of the year.
+     * @param delta - amount of containers that arrived (positive) or departed (negative).
+     */
+    void addEvent(int minute, int delta) { pendingEvents.emplace_back(minute, delta); }
+
+    /**
+     * Fold events that are not kept in the timeline into its baseline.
+     * @param balance - sum of the folded deltas.
+     * @param inbound - sum of the folded positive deltas.
+     */
+    void addBaseline(int balance, int inbound) {
+        baselineBalance += balance;
+        baselineInbound += inbound;
+    }
+
+    /**
+     * Remove all the events and free their memory, the baseline is kept.
+     */
+    void clearEvents();
+
+    int getBaselineBalance() const { return baselineBalance; }
+    int getBaselineInbound() const { return baselineInbound; }
+
+    /**
+     * @return True if there are events that were not flushed yet, otherwise false.
+     */
+    bool isDirty() const { return !pendingEvents.empty(); }
+
+    /**
+     * Merge the pending events into the sorted timeline and update the prefix sums.
+     */
+    void flush();
+
+    /**
+     * Get the containers balance at some time.
+     * @param minute - the time in minutes since the beginning of the year.
+     * @return The baseline plus the sum of all the flushed events that occurred at or before the given time.
+     */
+    int balanceAt(int minute) const;
+
+    /**
+     * Get the amount of containers that arrived until some time.
+     * @param minute - the time in minutes since the beginning of the year.
+     * @return The baseline plus the sum of all the flushed positive events that occurred at or before the given time.
+     */
+    int inboundAt(int minute) const;
+
+    /**
+     * Get the amount of containers that departed until some time.
+     * @param minute - the time in minutes since the beginning of the year.
+     * @return The baseline plus the sum of all the flushed negative events that occurred at or before the given time,
+     * as a positive value.
+     */
+    int outboundAt(int minute) const { return inboundAt(minute) - balanceAt(minute); }
+};
+
+
+#endif //HW2_BALANCETIMELINE_H
@@ -0,0 +1,305 @@
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <filesystem>
+#include <cstdlib>
+#include <cstring>
+#include "ContainersGraph.h"
+#include "TimesGraph.h"
+#include "PortRegistry.h"
+#include "SystemUtils.h"
+#include "ThreadPool.h"
+#include "BalanceScanner.h"
+#include "VoyageDataGenerator.h"
+#include "FileErrorException.h"
+using namespace std;
+
+const string USAGE_PROMPT = " [--scale small|medium|large|all] [--ports <n>] [--legs <n>] [--files <n>] [--days <n>]"
+                            " [--duplicates <ratio>] [--queries <n>] [--seed <n>] [--dir <directory>] [--keep]";
+const string CSV_HEADER = "scale,ports,legs_per_file,files,duplicate_ratio,operation,count,total_ms,ns_per_op";
+
+/**
+ * A named scale of data and queries to benchmark.
+ */
+struct BenchmarkScale {
+    string name;
+    VoyageDataConfig data;
+    // amount of queries of every query type
+    size_t queriesCount;
+};
+
+const vector<BenchmarkScale> DEFAULT_SCALES = {
+        {"small", {50, 50, 20, 300, 0.1, 1}, 10000},
+        {"medium", {500, 200, 200, 300, 0.1, 1}, 100000},
+        {"large", {5000, 500, 1000, 300, 0.1, 1}, 1000000},
+};
+
+/**
+ * The benchmark's program arguments.
+ */
+struct BenchmarkArguments {
+    vector<BenchmarkScale> scales;
+    string directory;
+    bool keepFiles = false;
+};
+
+/**
+ * Parse the benchmark's program arguments.
+ * Any of the data options replaces the default scales with a single custom scale.
+ * @param argc - amount of arguments.
+ * @param argv - the arguments.
+ * @throws invalid_argument - if the arguments are invalid.
+ * @return The parsed arguments.
+ */
+BenchmarkArguments parseArguments(int argc, char* argv[]) {
+    BenchmarkArguments arguments;
+    string scaleName = "all";
+    BenchmarkScale customScale = {"custom", DEFAULT_SCALES[0].data, DEFAULT_SCALES[0].queriesCount};
+    bool isCustom = false;
+
+    for (int i = 1; i < argc; i++) {
+        string flag = argv[i];
+        if (flag == "--keep") {
+            arguments.keepFiles = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            throw invalid_argument("missing value of " + flag);
+        }
+        string value = argv[++i];
+
+        if (flag == "--scale") {
+            scaleName = value;
+        } else if (flag == "--dir") {
+            arguments.directory = value;
+        } else if (flag == "--ports") {
+            customScale.data.portsCount = stoul(value);
+            isCustom = true;
+        } else if (flag == "--legs") {
+            customScale.data.legsPerFile = stoul(value);
+            isCustom = true;
+        } else if (flag == "--files") {
+            customScale.data.filesCount = stoul(value);
+            isCustom = true;
+        } else if (flag == "--days") {
+            customScale.data.dateSpreadDays = stoi(value);
+            isCustom = true;
+        } else if (flag == "--duplicates") {
+            customScale.data.duplicateRatio = stod(value);
+            isCustom = true;
+        } else if (flag == "--queries") {
+            customScale.queriesCount = stoul(value);
+            isCustom = true;
+        } else if (flag == "--seed") {
+            customScale.data.seed = stoul(value);
+            isCustom = true;
+        } else {
+            throw invalid_argument("unknown option " + flag);
+        }
+    }
+
+    if (isCustom) {
+        arguments.scales.push_back(customScale);
+    } else {
+        for (const auto& scale : DEFAULT_SCALES) {
+            if (scaleName == "all" || scaleName == scale.name) {
+                arguments.scales.push_back(scale);
+            }
+        }
+        if (arguments.scales.empty()) {
+            throw invalid_argument("unknown scale " + scaleName);
+        }
+    }
+    return arguments;
+}
+
+/**
+ * Print a single result line.
+ * @param scale - the benchmarked scale.
+ * @param operation - name of the benchmarked operation.
+ * @param count - amount of times the operation was executed.
+ * @param elapsed - total time of all the executions.
+ */
+void printResult(const BenchmarkScale& scale, const string& operation, size_t count, chrono::nanoseconds elapsed) {
+    double totalMs = static_cast<double>(elapsed.count()) / 1e6;
+    double nsPerOp = count > 0 ? static_cast<double>(elapsed.count()) / static_cast<double>(count) : 0;
+    cout << scale.name << ',' << scale.data.portsCount << ',' << scale.data.legsPerFile << ','
+         << scale.data.filesCount << ',' << scale.data.duplicateRatio << ',' << operation << ',' << count << ','
+         << totalMs << ',' << nsPerOp << endl;
+}
+
+/**
+ * Time an operation.
+ * @param operation - the operation to time.
+ * @return The time the operation took.
+ */
+template<typename Operation>
+chrono::nanoseconds measure(Operation operation) {
+    auto start = chrono::steady_clock::now();
+    operation();
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+}
+
+/**
+ * Generate the data of a scale, and benchmark loading it, querying it and printing it.
+ * @param scale - the scale to benchmark.
+ * @param directory - the directory to generate the data files into.
+ * @return Checksum of the queries results, so they can't be optimized away.
+ */
+long long runScale(const BenchmarkScale& scale, const string& directory) {
+    VoyageDataGenerator generator(scale.data);
+    vector<string> filenames = generator.generate(directory);
+
+    shared_ptr<PortRegistry> portRegistry = make_shared<PortRegistry>();
+    shared_ptr<ContainersGraph> containersGraph = make_shared<ContainersGraph>(portRegistry);
+    shared_ptr<TimesGraph> timesGraph = make_shared<TimesGraph>(portRegistry);
+
+    auto loadTime = measure([&]() {
+        for (const auto& filename : filenames) {
+            SystemUtils::loadFileToGraphs(filename, containersGraph, timesGraph, cerr);
+        }
+    });
+    printResult(scale, "load", filenames.size(), loadTime);
+
+    // the initial load of all the files together, into graphs of its own
+    {
+        shared_ptr<PortRegistry> initialRegistry = make_shared<PortRegistry>();
+        auto initialContainersGraph = make_shared<ContainersGraph>(initialRegistry);
+        auto initialTimesGraph = make_shared<TimesGraph>(initialRegistry);
+        ThreadPool threadPool;
+        auto initialLoadTime = measure([&]() {
+            SystemUtils::loadFilesToGraphs(filenames, initialContainersGraph, initialTimesGraph, threadPool);
+        });
+        printResult(scale, "initial_load", filenames.size(), initialLoadTime);
+    }
+
+    // the queries arguments are drawn before timing
+    vector<string> portsNames;
+    for (PortId port = 0; port < portRegistry->size(); port++) {
+        if (containersGraph->hasPort(port) && timesGraph->hasPort(port)) {
+            portsNames.emplace_back(portRegistry->getName(port));
+        }
+    }
+    if (portsNames.empty()) {
+        return 0;
+    }
+    mt19937 random(scale.data.seed);
+    uniform_int_distribution<size_t> portDistribution(0, portsNames.size() - 1);
+    uniform_int_distribution<int> minuteDistribution(0, 365 * 24 * 60 - 1);
+    vector<size_t> queriesPorts(scale.queriesCount);
+    vector<Date> queriesDates(scale.queriesCount);
+    for (size_t i = 0; i < scale.queriesCount; i++) {
+        queriesPorts[i] = portDistribution(random);
+        queriesDates[i] = Date::fromMinutes(minuteDistribution(random));
+    }
+
+    long long checksum = 0;
+    auto balanceTime = measure([&]() {
+        for (size_t i = 0; i < scale.queriesCount; i++) {
+            checksum += containersGraph->balance(portsNames[queriesPorts[i]], queriesDates[i]);
+        }
+    });
+    printResult(scale, "balance", scale.queriesCount, balanceTime);
+
+    // the same few (port, date) pairs asked over and over
+    const size_t repeatedPairsCount = min<size_t>(1000, scale.queriesCount);
+    auto repeatedBalanceTime = measure([&]() {
+        for (size_t i = 0; i < scale.queriesCount; i++) {
+            size_t pair = i % repeatedPairsCount;
+            checksum += containersGraph->balance(portsNames[queriesPorts[pair]], queriesDates[pair]);
+        }
+    });
+    printResult(scale, "balance_repeated", scale.queriesCount, repeatedBalanceTime);
+
+    // a batch of the same queries, evaluated by scanning the sails without the timelines
+    const size_t scanQueriesCount = min<size_t>(1000, scale.queriesCount);
+    vector<pair<PortId, int>> scanQueries;
+    for (size_t i = 0; i < scanQueriesCount; i++) {
+        scanQueries.emplace_back(portRegistry->find(portsNames[queriesPorts[i]]), queriesDates[i].toMinutes());
+    }
+    vector<pair<int, int>> scanVolumes;
+    auto scanTime = measure([&]() {
+        scanVolumes = BalanceScanner::scan(containersGraph->getSails(), scanQueries);
+    });
+    for (size_t i = 0; i < scanQueriesCount; i++) {
+        int scanBalance = scanVolumes[i].first - scanVolumes[i].second;
+        if (scanBalance != containersGraph->balance(portsNames[queriesPorts[i]], queriesDates[i])) {
+            cerr << "balance scan mismatch at query " << i << endl;
+        }
+        checksum += scanBalance;
+    }
+    printResult(scale, BalanceScanner::usesAvx2() ? "balance_scan_avx2" : "balance_scan_scalar", scanQueriesCount, scanTime);
+
+    auto inboundTime = measure([&]() {
+        for (size_t i = 0; i < scale.queriesCount; i++) {
+            checksum += static_cast<long long>(timesGraph->inbound(portsNames[queriesPorts[i]]).size());
+        }
+    });
+    printResult(scale, "inbound", scale.queriesCount, inboundTime);
+
+    auto outboundTime = measure([&]() {
+        for (size_t i = 0; i < scale.queriesCount; i++) {
+            checksum += static_cast<long long>(timesGraph->outbound(portsNames[queriesPorts[i]]).size());
+        }
+    });
+    printResult(scale, "outbound", scale.queriesCount, outboundTime);
+
+    auto printTime = measure([&]() {
+        SystemUtils::printGraphs(directory + "/output.dat", containersGraph, timesGraph);
+    });
+    printResult(scale, "print", 1, printTime);
+
+    return checksum;
+}
+
+int main(int argc, char* argv[]) {
+    BenchmarkArguments arguments;
+    try {
+        arguments = parseArguments(argc, argv);
+    } catch (exception& e) {
+        cerr << e.what() << endl;
+        cerr << "Usage: " << argv[0] << USAGE_PROMPT << endl;
+        return 1;
+    }
+
+    // generated files go to a fresh directory of a unique name that is removed at the end, unless asked to keep it,
+    // so concurrent runs don't share it and an existing directory is never removed
+    bool isTemporaryDirectory = arguments.directory.empty();
+    if (isTemporaryDirectory) {
+        string pattern = (filesystem::temp_directory_path() / "hw2_benchmark_XXXXXX").string();
+        if (mkdtemp(pattern.data()) == nullptr) {
+            cerr << "Failed to create a temporary directory: " << strerror(errno) << endl;
+            return 1;
+        }
+        arguments.directory = pattern;
+        if (arguments.keepFiles) {
+            cerr << "data files directory: " << arguments.directory << endl;
+        }
+    } else {
+        filesystem::create_directories(arguments.directory);
+    }
+    bool removeDirectory = isTemporaryDirectory && !arguments.keepFiles;
+
+    cout << CSV_HEADER << endl;
+    long long checksum = 0;
+    try {
+        for (const auto& scale : arguments.scales) {
+            checksum += runScale(scale, arguments.directory);
+        }
+    } catch (FileErrorException& e) {
+        cerr << e.what() << endl;
+        if (removeDirectory) {
+            filesystem::remove_all(arguments.directory);
+        }
+        return 1;
+    }
+    cerr << "checksum: " << checksum << endl;
+
+    if (removeDirectory) {
+        filesystem::remove_all(arguments.directory);
+    }
+    return 0;
+}
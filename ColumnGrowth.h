@@ -0,0 +1,53 @@
+#ifndef HW2_COLUMNGROWTH_H
+#define HW2_COLUMNGROWTH_H
+#include <iostream>
+#include <algorithm>
+using namespace std;
+
+/**
+ * A class that makes room in containers that are filled in batches.
+ * A container grows to at least twice its size, so loading many batches stays amortized linear
+ * instead of reallocating or rehashing on every batch.
+ */
+class ColumnGrowth {
+private:
+    /**
+     * @param size - amount of stored values.
+     * @param count - amount of values to make room for, besides the stored ones.
+     * @return The capacity to grow to.
+     */
+    static size_t grownCapacity(size_t size, size_t count) { return max(size + count, 2 * size); }
+public:
+    /**
+     * Make room for more values in parallel columns, so adding them reallocates the columns at most once.
+     * @param count - amount of values to make room for, besides the stored ones.
+     * @param first - the first column.
+     * @param columns - the other columns, of the first column's size and capacity.
+     */
+    template<typename Column, typename... Columns>
+    static void reserveMore(size_t count, Column& first, Columns&... columns) {
+        size_t size = first.size();
+        if (size + count <= first.capacity()) {
+            return;
+        }
+        size_t capacity = grownCapacity(size, count);
+        first.reserve(capacity);
+        (columns.reserve(capacity), ...);
+    }
+
+    /**
+     * Make room for more keys in a hash container, so adding them rehashes it at most once.
+     * @param keys - the hash container.
+     * @param count - amount of keys to make room for, besides the stored ones.
+     */
+    template<typename HashContainer>
+    static void reserveMoreKeys(HashContainer& keys, size_t count) {
+        if (keys.size() + count <= keys.bucket_count() * keys.max_load_factor()) {
+            return;
+        }
+        keys.reserve(grownCapacity(keys.size(), count));
+    }
+};
+
+
+#endif //HW2_COLUMNGROWTH_H
@@ -0,0 +1,49 @@
+#include "CommandStats.h"
+#include "Commands.h"
+
+const string CommandStats::INVALID_COMMAND = "invalid";
+const string CommandStats::FOLLOW_UPDATE = "follow";
+
+CommandStats::CommandStats() {
+    for (const string* command : {&Commands::LOAD_COMMAND, &Commands::SAVE_COMMAND, &Commands::OUTBOUND_COMMAND,
+                                  &Commands::INBOUND_COMMAND, &Commands::BALANCE_COMMAND, &Commands::ROUTE_COMMAND,
+                                  &Commands::EARLIEST_COMMAND, &Commands::PROFILE_COMMAND, &Commands::BALANCES_COMMAND,
+                                  &Commands::TOP_COMMAND, &Commands::PRINT_COMMAND, &Commands::COMPACT_COMMAND, &FOLLOW_UPDATE,
+                                  &INVALID_COMMAND}) {
+        histograms.emplace(piecewise_construct, forward_as_tuple(*command), forward_as_tuple());
+    }
+}
+
+CommandStats &CommandStats::global() {
+    static CommandStats stats;
+    return stats;
+}
+
+CommandStats::Timer CommandStats::time(string_view command) {
+    auto found = histograms.find(command);
+    if (found == histograms.end()) {
+        found = histograms.find(INVALID_COMMAND);
+    }
+    return Timer(found->second);
+}
+
+void CommandStats::print(OutputWriter &out) const {
+    out << "Commands Stats" << '\n';
+    for (const auto& [command, histogram] : histograms) {
+        if (histogram.getCount() == 0) {
+            continue;
+        }
+        out << command << ": " << histogram.getCount() << " calls, p50 " << histogram.percentile(50) << " ns, p90 "
+            << histogram.percentile(90) << " ns, p99 " << histogram.percentile(99) << " ns, max "
+            << histogram.getMax() << " ns" << '\n';
+    }
+
+    auto errorsCount = [this](CommandError error) {
+        return errors[static_cast<size_t>(error)].load(memory_order_relaxed);
+    };
+    out << "Errors: " << errorsCount(CommandError::PORT_NOT_EXISTS) << " port not exists, "
+        << errorsCount(CommandError::INVALID_INPUT) << " invalid input, "
+        << errorsCount(CommandError::FILE_ERROR) << " file error, "
+        << errorsCount(CommandError::USAGE) << " usage, "
+        << errorsCount(CommandError::COMPACTED_DATE) << " compacted date" << '\n';
+}
@@ -0,0 +1,86 @@
+#ifndef HW2_COMMANDSTATS_H
+#define HW2_COMMANDSTATS_H
+#include <iostream>
+#include <map>
+#include <string>
+#include <chrono>
+#include "LatencyHistogram.h"
+#include "OutputWriter.h"
+using namespace std;
+
+/**
+ * Kinds of errors reported by the system commands.
+ */
+enum class CommandError {
+    PORT_NOT_EXISTS,
+    INVALID_INPUT,
+    FILE_ERROR,
+    USAGE,
+    COMPACTED_DATE,
+    ERRORS_COUNT
+};
+
+/**
+ * A class that collects the calls count and latency histogram of every command type,
+ * and the count of every kind of error. All the counters are atomic, so commands that run concurrently
+ * can record into the same stats.
+ */
+class CommandStats {
+private:
+    // latency of every command type, the keys are fixed at construction so lookups don't need a lock
+    map<string, LatencyHistogram, less<>> histograms;
+    array<atomic<uint64_t>, static_cast<size_t>(CommandError::ERRORS_COUNT)> errors{};
+
+    CommandStats();
+public:
+    // key of the commands that are not known
+    static const string INVALID_COMMAND;
+    // key of the updates applied from a followed feed
+    static const string FOLLOW_UPDATE;
+
+    /**
+     * Measures the time from its creation to its destruction, and records it as a command's latency.
+     */
+    class Timer {
+    private:
+        LatencyHistogram& histogram;
+        chrono::steady_clock::time_point start;
+    public:
+        explicit Timer(LatencyHistogram& histogram) : histogram(histogram), start(chrono::steady_clock::now()) {}
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+        ~Timer() {
+            auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+            histogram.record(static_cast<uint64_t>(elapsed.count()));
+        }
+    };
+
+    /**
+     * @return The stats of the whole system.
+     */
+    static CommandStats& global();
+
+    /**
+     * Start measuring a command.
+     * @param command - the command keyword, unknown keywords are counted as invalid commands.
+     * @return A timer that records the command's latency when destroyed.
+     */
+    Timer time(string_view command);
+
+    /**
+     * Count an error.
+     * @param error - the kind of the error.
+     */
+    void recordError(CommandError error) {
+        errors[static_cast<size_t>(error)].fetch_add(1, memory_order_relaxed);
+    }
+
+    /**
+     * Print the calls count, the latency percentiles of every command that was called, and the errors counts.
+     * @param out - writer to print the stats into.
+     */
+    void print(OutputWriter& out) const;
+};
+
+
+#endif //HW2_COMMANDSTATS_H
@@ -1,13 +1,29 @@
 #include "Commands.h"
 
 const string Commands::LOAD_COMMAND = "load";
+const string Commands::SAVE_COMMAND = "save";
 const string Commands::OUTBOUND_COMMAND = "outbound";
 const string Commands::INBOUND_COMMAND = "inbound";
 const string Commands::BALANCE_COMMAND = "balance";
+const string Commands::ROUTE_COMMAND = "route";
+const string Commands::EARLIEST_COMMAND = "earliest";
+const string Commands::PROFILE_COMMAND = "profile";
+const string Commands::BALANCES_COMMAND = "balances";
+const string Commands::TOP_COMMAND = "top";
+const string Commands::COMPACT_COMMAND = "compact";
 const string Commands::PRINT_COMMAND = "print";
+const string Commands::STATS_COMMAND = "stats";
 const string Commands::EXIT_COMMAND = "exit";
+const string Commands::STATS_OPTION = "stats";
 const string Commands::USAGE_STRING = "USAGE:\t‘load’ <file> *or* \n\t\t"
-                                      " <node>,'inbound' *or* \n\t\t"
-                                      " <node>,’outbound’ *or* \n\t\t"
+                                      " ‘save’ <file> *or* \n\t\t"
+                                      " <node>,'inbound'[,'stats'] *or* \n\t\t"
+                                      " <node>,’outbound’[,'stats'] *or* \n\t\t"
                                       " <node>,’balance’,dd/mm HH:mm *or* \n\t\t"
-                                      " ‘print’ *or* \n\t\t ‘exit’ *to terminate*";
\ No newline at end of file
+                                      " <node>,’route’,<node> *or* \n\t\t"
+                                      " <node>,’earliest’,<node>,dd/mm HH:mm *or* \n\t\t"
+                                      " <node>,’profile’,<node>,dd/mm HH:mm,dd/mm HH:mm *or* \n\t\t"
+                                      " ‘balances’,dd/mm HH:mm *or* \n\t\t"
+                                      " ‘top’,<k>,dd/mm HH:mm *or* \n\t\t"
+                                      " ‘compact’,dd/mm HH:mm *or* \n\t\t"
+                                      " ‘print’ [‘stats’] *or* \n\t\t ‘stats’ *or* \n\t\t ‘exit’ *to terminate*";
\ No newline at end of file
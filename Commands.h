@@ -5,11 +5,21 @@ using namespace std;
 
 struct Commands {
     static const string LOAD_COMMAND;
+    static const string SAVE_COMMAND;
     static const string OUTBOUND_COMMAND;
     static const string INBOUND_COMMAND;
     static const string BALANCE_COMMAND;
+    static const string ROUTE_COMMAND;
+    static const string EARLIEST_COMMAND;
+    static const string PROFILE_COMMAND;
+    static const string BALANCES_COMMAND;
+    static const string TOP_COMMAND;
+    static const string COMPACT_COMMAND;
     static const string PRINT_COMMAND;
+    static const string STATS_COMMAND;
     static const string EXIT_COMMAND;
+    // optional last argument of the inbound, outbound and print commands
+    static const string STATS_OPTION;
     static const string USAGE_STRING;
 };
 
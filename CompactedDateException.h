@@ -0,0 +1,16 @@
+#ifndef HW2_COMPACTEDDATEEXCEPTION_H
+#define HW2_COMPACTEDDATEEXCEPTION_H
+#include <istream>
+#include <exception>
+
+class CompactedDateException : public std::exception {
+private:
+    std::string message;
+public:
+    explicit CompactedDateException(std::string message) : message(std::move(message)) {}
+    const char * what() const noexcept override {
+        return message.c_str();
+    }
+};
+
+#endif //HW2_COMPACTEDDATEEXCEPTION_H
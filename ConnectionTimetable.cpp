@@ -0,0 +1,153 @@
+#include "ConnectionTimetable.h"
+#include <algorithm>
+#include <climits>
+
+namespace {
+    const int UNREACHABLE = INT_MAX;
+    const size_t NO_CONNECTION = SIZE_MAX;
+}
+
+void ConnectionTimetable::addConnection(PortId srcPort, PortId destPort, int departureMinute, int arrivalMinute) {
+    if (arrivalMinute < departureMinute) {
+        return;
+    }
+    pendingConnections.push_back({departureMinute, arrivalMinute, srcPort, destPort});
+}
+
+void ConnectionTimetable::flush() {
+    if (pendingConnections.empty()) {
+        return;
+    }
+
+    // merge the new connections into the sorted ones, equal connections end up adjacent
+    sort(pendingConnections.begin(), pendingConnections.end());
+    size_t oldSize = connections.size();
+    connections.insert(connections.end(), pendingConnections.begin(), pendingConnections.end());
+    pendingConnections.clear();
+    inplace_merge(connections.begin(), connections.begin() + static_cast<long>(oldSize), connections.end());
+    connections.erase(unique(connections.begin(), connections.end()), connections.end());
+}
+
+size_t ConnectionTimetable::removeBefore(int minute) {
+    flush();
+    auto first = lower_bound(connections.begin(), connections.end(), minute, [](const Connection& connection, int value) {
+        return connection.departureMinute < value;
+    });
+    size_t removedCount = first - connections.begin();
+    connections.erase(connections.begin(), first);
+    return removedCount;
+}
+
+optional<vector<Connection>> ConnectionTimetable::earliestArrival(PortId srcPort, PortId destPort, int departureMinute,
+                                                                  size_t portsCount) const {
+    if (srcPort == destPort) {
+        return vector<Connection>();
+    }
+
+    // every thread keeps its own scan arrays between queries
+    thread_local vector<int> arrivals;
+    thread_local vector<size_t> incomingConnections;
+    arrivals.assign(portsCount, UNREACHABLE);
+    incomingConnections.assign(portsCount, NO_CONNECTION);
+    arrivals[srcPort] = departureMinute;
+
+    // connections that depart before the given time can't be taken
+    auto first = lower_bound(connections.begin(), connections.end(), departureMinute,
+                             [](const Connection& connection, int minute) {
+        return connection.departureMinute < minute;
+    });
+    for (auto it = first; it != connections.end(); ++it) {
+        const Connection& connection = *it;
+        if (connection.departureMinute >= arrivals[destPort]) {
+            // the rest of the connections depart after the destination was reached
+            break;
+        }
+        if (arrivals[connection.srcPort] <= connection.departureMinute &&
+            connection.arrivalMinute < arrivals[connection.destPort]) {
+            arrivals[connection.destPort] = connection.arrivalMinute;
+            incomingConnections[connection.destPort] = it - connections.begin();
+        }
+    }
+
+    if (arrivals[destPort] == UNREACHABLE) {
+        return nullopt;
+    }
+
+    // walk back from the destination to the source
+    vector<Connection> journey;
+    for (PortId port = destPort; port != srcPort; port = connections[incomingConnections[port]].srcPort) {
+        journey.push_back(connections[incomingConnections[port]]);
+    }
+    reverse(journey.begin(), journey.end());
+    return journey;
+}
+
+vector<pair<int, int>> ConnectionTimetable::profile(PortId srcPort, PortId destPort, int fromMinute, int toMinute,
+                                                    size_t portsCount) const {
+    vector<pair<int, int>> journeys;
+    if (fromMinute > toMinute) {
+        return journeys;
+    }
+    if (srcPort == destPort) {
+        // staying in the port takes no time
+        journeys.emplace_back(fromMinute, fromMinute);
+        return journeys;
+    }
+
+    // (departure, arrival) journeys to the destination from every port, appended by decreasing departure.
+    // every appended journey arrives strictly earlier than the previous ones, so both are decreasing.
+    thread_local vector<vector<pair<int, int>>> profiles;
+    if (profiles.size() < portsCount) {
+        profiles.resize(portsCount);
+    }
+    for (size_t port = 0; port < portsCount; port++) {
+        profiles[port].clear();
+    }
+
+    // earliest arrival to the destination when being at a port at some minute
+    auto arrivalFrom = [](const vector<pair<int, int>>& portProfile, int minute) {
+        // the last journey that departs at or after the given minute is the one that arrives the earliest
+        auto after = partition_point(portProfile.begin(), portProfile.end(), [minute](const pair<int, int>& journey) {
+            return journey.first >= minute;
+        });
+        return after == portProfile.begin() ? UNREACHABLE : prev(after)->second;
+    };
+
+    // keep a journey unless a journey of the same profile that departs later arrives as early
+    auto addJourney = [](vector<pair<int, int>>& portProfile, int departure, int arrival) {
+        if (!portProfile.empty() && portProfile.back().second <= arrival) {
+            return;
+        }
+        if (!portProfile.empty() && portProfile.back().first == departure) {
+            portProfile.back().second = arrival;
+        } else {
+            portProfile.emplace_back(departure, arrival);
+        }
+    };
+
+    // the source's journeys that depart in the window, pruned only by each other:
+    // a journey that departs after the window must not hide them
+    vector<pair<int, int>> windowJourneys;
+
+    // scan the connections that depart in or after the window by decreasing departure
+    auto first = lower_bound(connections.begin(), connections.end(), fromMinute,
+                             [](const Connection& connection, int minute) {
+        return connection.departureMinute < minute;
+    });
+    for (auto it = connections.end(); it != first;) {
+        const Connection& connection = *--it;
+        int arrival = connection.destPort == destPort ? connection.arrivalMinute
+                                                      : arrivalFrom(profiles[connection.destPort], connection.arrivalMinute);
+        if (arrival == UNREACHABLE) {
+            continue;
+        }
+
+        addJourney(profiles[connection.srcPort], connection.departureMinute, arrival);
+        if (connection.srcPort == srcPort && connection.departureMinute <= toMinute) {
+            addJourney(windowJourneys, connection.departureMinute, arrival);
+        }
+    }
+
+    journeys.assign(windowJourneys.rbegin(), windowJourneys.rend());
+    return journeys;
+}
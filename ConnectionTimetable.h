@@ -0,0 +1,102 @@
+#ifndef HW2_CONNECTIONTIMETABLE_H
+#define HW2_CONNECTIONTIMETABLE_H
+#include <iostream>
+#include <vector>
+#include <optional>
+#include <compare>
+#include "Port.h"
+using namespace std;
+
+/**
+ * A single scheduled leg: departs from a port at some minute and arrives to another port at a later minute.
+ */
+struct Connection {
+    int departureMinute;
+    int arrivalMinute;
+    PortId srcPort;
+    PortId destPort;
+
+    // ordered by departure first, so the timetable is sorted by departure
+    auto operator<=>(const Connection& other) const = default;
+};
+
+/**
+ * A class that represent the timetable of all the scheduled sails, as a flat array of connections sorted by
+ * departure time. Time dependent queries are answered by the connection scan algorithm, a single linear pass
+ * over the array. A container can continue with any connection that departs at or after the minute it arrived.
+ * The same leg added again (a file that is loaded twice) is kept once.
+ */
+class ConnectionTimetable {
+private:
+    // distinct connections sorted by departure minute (then by arrival and ports)
+    vector<Connection> connections;
+    // connections added since the last flush, not sorted yet
+    vector<Connection> pendingConnections;
+public:
+    /**
+     * Add a scheduled leg to the timetable.
+     * The connection is visible to the queries only after the next flush.
+     * Legs that arrive before they depart can't be part of a journey and are ignored.
+     * @param srcPort - id of the leg's source port.
+     * @param destPort - id of the leg's destination port.
+     * @param departureMinute - departure time in minutes since the beginning of the year.
+     * @param arrivalMinute - arrival time in minutes since the beginning of the year.
+     */
+    void addConnection(PortId srcPort, PortId destPort, int departureMinute, int arrivalMinute);
+
+    /**
+     * @return True if there are connections that were not flushed yet, otherwise false.
+     */
+    bool isDirty() const { return !pendingConnections.empty(); }
+
+    /**
+     * Merge the pending connections into the sorted timetable, dropping the ones it already has.
+     */
+    void flush();
+
+    /**
+     * Remove the connections that depart before some time.
+     * @param minute - the earliest departure to keep, in minutes since the beginning of the year.
+     * @return Amount of the removed connections.
+     */
+    size_t removeBefore(int minute);
+
+    /**
+     * @return The flushed connections, sorted by departure.
+     */
+    const vector<Connection>& getConnections() const { return connections; }
+
+    /**
+     * @return The connections that were not flushed yet, in insertion order.
+     */
+    const vector<Connection>& getPendingConnections() const { return pendingConnections; }
+
+    /**
+     * Find the journey that arrives the earliest to a port, leaving another port at some time.
+     * @param srcPort - id of the journey's source port.
+     * @param destPort - id of the journey's destination port.
+     * @param departureMinute - the earliest time the journey may depart, in minutes since the beginning of the year.
+     * @param portsCount - upper bound of the ports ids.
+     * @return The journey's legs in sailing order (empty if the source is the destination),
+     * or nullopt if the destination can't be reached.
+     */
+    optional<vector<Connection>> earliestArrival(PortId srcPort, PortId destPort, int departureMinute,
+                                                 size_t portsCount) const;
+
+    /**
+     * Find the earliest arrival of every departure time in a window, in a single scan.
+     * Only the journeys that are not dominated are returned: a journey in the window that departs later and arrives
+     * earlier or at the same time as another one hides it. Journeys that depart after the window hide nothing.
+     * @param srcPort - id of the journeys source port.
+     * @param destPort - id of the journeys destination port.
+     * @param fromMinute - beginning of the departure window, in minutes since the beginning of the year.
+     * @param toMinute - end of the departure window, in minutes since the beginning of the year.
+     * @param portsCount - upper bound of the ports ids.
+     * @return (departure minute, arrival minute) pairs of the journeys, sorted by departure.
+     */
+    vector<pair<int, int>> profile(PortId srcPort, PortId destPort, int fromMinute, int toMinute,
+                                   size_t portsCount) const;
+};
+
+
+#endif //HW2_CONNECTIONTIMETABLE_H
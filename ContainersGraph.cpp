@@ -1,134 +1,307 @@
 #include "ContainersGraph.h"
 #include "PortNotExistsException.h"
-#include <fstream>
+#include "CompactedDateException.h"
+#include "RadixSort.h"
+#include "ColumnGrowth.h"
 
-shared_ptr<Port> ContainersGraph::findPortByName(const std::string &portName) {
-    for (const auto& port : ports) {
-        if (port->getName() == portName) {
-            return port;
-        }
+PortId ContainersGraph::findPortByName(const std::string &portName) const {
+    PortId port = portRegistry->find(portName);
+    if (port == INVALID_PORT_ID || !hasPort(port)) {
+        return INVALID_PORT_ID;
     }
-    return nullptr;
+    return port;
 }
 
-bool ContainersGraph::sailExists(shared_ptr<Port> srcPort, shared_ptr<Port> destPort, shared_ptr<Date> startDate,
-                                 shared_ptr<Date> endDate) {
-    for (const auto& sailTuple : sails) {
-        const auto& foundedSrcPort = get<0>(sailTuple);
-        const auto& foundedDestPort = get<1>(sailTuple);
-        const auto& foundedSailData = get<2>(sailTuple);
-        const auto& foundedStartDate = foundedSailData->getStartDate()->toMinutes();
-        const auto& foundedEndDate = foundedSailData->getEndDate()->toMinutes();
-
-        bool sameSrc = foundedSrcPort->getName() == srcPort->getName();
-        bool sameDest = foundedDestPort->getName() == destPort->getName();
-        bool sameStartDate = foundedStartDate == startDate->toMinutes();
-        bool sameEndDate = foundedEndDate == endDate->toMinutes();
+void ContainersGraph::reservePort(PortId port) {
+    if (port >= ports.size()) {
+        ports.resize(port + 1, false);
+        timelines.resize(port + 1);
+    }
+}
 
-        // found edge with the same values
-        if (sameSrc && sameDest && sameStartDate && sameEndDate) {
-            return true;
-        }
+void ContainersGraph::checkHorizon(Date date) const {
+    if (date.toMinutes() < horizonMinute) {
+        throw CompactedDateException(date.getAsString() + " is before the compaction horizon "
+                                     + getHorizon().getAsString() + "\n");
     }
+}
 
-    // no matching edge found
-    return false;
+shared_ptr<ContainersGraph> ContainersGraph::clone(shared_ptr<PortRegistry> portRegistry) const {
+    auto copy = make_shared<ContainersGraph>(*this);
+    copy->portRegistry = std::move(portRegistry);
+    return copy;
 }
 
-void ContainersGraph::addPort(shared_ptr<Port> port) {
-    this->ports.insert(std::move(port));
+void ContainersGraph::addPort(PortId port) {
+    reservePort(port);
+    ports[port] = true;
 }
 
-void ContainersGraph::addSail(shared_ptr<Port> srcPort, shared_ptr<Port> destPort, shared_ptr<Date> startDate,
-                              shared_ptr<Date> endDate, int containers) {
-    if (!sailExists(srcPort, destPort, startDate, endDate)) {
-        shared_ptr<SailContainersData> sailData = std::make_shared<SailContainersData>(startDate, endDate, containers);
-        sails.emplace_back(std::move(srcPort), std::move(destPort), std::move(sailData));
+void ContainersGraph::addSail(PortId srcPort, PortId destPort, Date startDate,
+                              Date endDate, int containers) {
+    // insert returns false if a sail with the same values already exists
+    SailKey key{srcPort, destPort, startDate.toMinutes(), endDate.toMinutes()};
+    if (max(key.startMinute, key.endMinute) < horizonMinute) {
+        // the sail's period was compacted
+        if (foldLateSail(key, containers)) {
+            mergeFoldedKeys({key});
+        }
+        return;
+    }
+    if (sailsKeys.insert(key).second) {
+        latestEndMinute = max(latestEndMinute, key.endMinute);
+        sails.push_back(srcPort, destPort, startDate, endDate, containers);
+
+        // containers depart from the source port and arrive to the destination port
+        reservePort(srcPort);
+        reservePort(destPort);
+        for (PortId port : {srcPort, destPort}) {
+            if (!timelines[port].isDirty()) {
+                dirtyPorts.push_back(port);
+            }
+        }
+        timelines[srcPort].addEvent(key.startMinute, -containers);
+        timelines[destPort].addEvent(key.endMinute, containers);
     }
 }
 
-vector<tuple<shared_ptr<Port>, int>> ContainersGraph::inboundContainers(const shared_ptr<Port>& port, const shared_ptr<Date>& date) {
-    vector<tuple<shared_ptr<Port>, int>> inboundContainers;
+void ContainersGraph::addSails(const ContainersSails& newSails) {
+    const auto& srcPorts = newSails.getSrcPorts();
+    const auto& destPorts = newSails.getDestPorts();
+    const auto& startMinutes = newSails.getStartMinutes();
+    const auto& endMinutes = newSails.getEndMinutes();
+    auto keyOf = [&](uint32_t sail) {
+        return SailKey{srcPorts[sail], destPorts[sail], startMinutes[sail], endMinutes[sail]};
+    };
 
-    for (const auto& sailTuple : sails) {
-        const auto& srcPort = get<0>(sailTuple);
-        const auto& destPort = get<1>(sailTuple);
-        const auto& sailData = get<2>(sailTuple);
+    // equal keys end up adjacent, with the earliest sail first since the sort is stable
+    auto order = RadixSort::sortIndexes(newSails.size(), 4, [&](uint32_t sail, size_t word) -> uint32_t {
+        switch (word) {
+            case 0: return srcPorts[sail];
+            case 1: return destPorts[sail];
+            case 2: return static_cast<uint32_t>(startMinutes[sail]);
+            default: return static_cast<uint32_t>(endMinutes[sail]);
+        }
+    });
 
-        // sail from some port to the inbound port should end before the given time (containers arrived)
-        bool beforeFinalDate = sailData->getEndDate()->toMinutes() <= date->toMinutes();
+    // keep the first sail of every key unless the graph already has it, fold it if its period was compacted
+    vector<bool> kept(newSails.size(), false);
+    size_t keptCount = 0;
+    vector<SailKey> lateKeys;
+    for (size_t i = 0; i < order.size(); i++) {
+        SailKey key = keyOf(order[i]);
+        if (i > 0 && keyOf(order[i - 1]) == key) {
+            continue;
+        }
+        if (max(key.startMinute, key.endMinute) < horizonMinute) {
+            if (foldLateSail(key, newSails.getContainers(order[i]))) {
+                lateKeys.push_back(key);
+            }
+            continue;
+        }
+        if (sailsKeys.contains(key)) {
+            continue;
+        }
+        kept[order[i]] = true;
+        keptCount++;
+    }
+    if (!lateKeys.empty()) {
+        mergeFoldedKeys(std::move(lateKeys));
+    }
 
-        if (destPort->getName() == port->getName() && beforeFinalDate) {
-            inboundContainers.emplace_back(srcPort, sailData->getContainers());
+    // append the kept sails in their order, and update the indexes once
+    sails.reserveMore(keptCount);
+    ColumnGrowth::reserveMoreKeys(sailsKeys, keptCount);
+    for (uint32_t sail = 0; sail < newSails.size(); sail++) {
+        if (!kept[sail]) {
+            continue;
         }
+        SailKey key = keyOf(sail);
+        int containers = newSails.getContainers(sail);
+        sails.push_back(key.srcPort, key.destPort, newSails.getStartDate(sail), newSails.getEndDate(sail), containers);
+        sailsKeys.insert(key);
+        latestEndMinute = max(latestEndMinute, key.endMinute);
+
+        // containers depart from the source port and arrive to the destination port
+        reservePort(key.srcPort);
+        reservePort(key.destPort);
+        for (PortId port : {key.srcPort, key.destPort}) {
+            if (!timelines[port].isDirty()) {
+                dirtyPorts.push_back(port);
+            }
+        }
+        timelines[key.srcPort].addEvent(key.startMinute, -containers);
+        timelines[key.destPort].addEvent(key.endMinute, containers);
+    }
+}
+
+bool ContainersGraph::foldLateSail(const SailKey& key, int containers) {
+    if (binary_search(foldedKeys.begin(), foldedKeys.end(), key)) {
+        return false;
     }
+    reservePort(key.srcPort);
+    reservePort(key.destPort);
+    timelines[key.srcPort].addBaseline(-containers, 0);
+    timelines[key.destPort].addBaseline(containers, containers);
+    return true;
+}
 
-    return inboundContainers;
+void ContainersGraph::mergeFoldedKeys(vector<SailKey> keys) {
+    sort(keys.begin(), keys.end());
+    size_t oldSize = foldedKeys.size();
+    foldedKeys.insert(foldedKeys.end(), keys.begin(), keys.end());
+    inplace_merge(foldedKeys.begin(), foldedKeys.begin() + static_cast<long>(oldSize), foldedKeys.end());
 }
 
-vector<tuple<shared_ptr<Port>, int>>
-ContainersGraph::outboundContainers(const shared_ptr<Port> &port, const shared_ptr<Date> &date) {
-    vector<tuple<shared_ptr<Port>, int>> outboundContainers;
+size_t ContainersGraph::compact(Date horizon) {
+    if (horizon.toMinutes() <= horizonMinute) {
+        return 0;
+    }
+    horizonMinute = horizon.toMinutes();
 
-    for (const auto& sailTuple : sails) {
-        const auto& srcPort = get<0>(sailTuple);
-        const auto& destPort = get<1>(sailTuple);
-        const auto& sailData = get<2>(sailTuple);
+    // the timelines are rebuilt from the kept sails
+    for (auto& timeline : timelines) {
+        timeline.clearEvents();
+    }
+    dirtyPorts.clear();
 
-        // sail from the given port to some port should start before the given time (containers departs)
-        bool beforeFinalDate = sailData->getStartDate()->toMinutes() <= date->toMinutes();
+    ContainersSails keptSails;
+    vector<SailKey> newFoldedKeys;
+    for (size_t sail = 0; sail < sails.size(); sail++) {
+        PortId srcPort = sails.getSrcPort(sail);
+        PortId destPort = sails.getDestPort(sail);
+        int startMinute = sails.getStartMinutes()[sail];
+        int endMinute = sails.getEndMinutes()[sail];
+        int containers = sails.getContainers(sail);
 
-        if (srcPort->getName() == port->getName() && beforeFinalDate) {
-            outboundContainers.emplace_back(destPort, sailData->getContainers());
+        if (max(startMinute, endMinute) < horizonMinute) {
+            // both events are before any date that can still be queried
+            timelines[srcPort].addBaseline(-containers, 0);
+            timelines[destPort].addBaseline(containers, containers);
+            SailKey key{srcPort, destPort, startMinute, endMinute};
+            sailsKeys.erase(key);
+            newFoldedKeys.push_back(key);
+            continue;
         }
+
+        keptSails.push_back(srcPort, destPort, sails.getStartDate(sail), sails.getEndDate(sail), containers);
+        timelines[srcPort].addEvent(startMinute, -containers);
+        timelines[destPort].addEvent(endMinute, containers);
+    }
+
+    size_t freedSails = sails.size() - keptSails.size();
+    sails = std::move(keptSails);
+    sailsKeys.rehash(0);
+    mergeFoldedKeys(std::move(newFoldedKeys));
+    for (auto& timeline : timelines) {
+        timeline.flush();
     }
+    return freedSails;
+}
+
+size_t ContainersGraph::applyRetention() {
+    if (retentionMinutes == 0) {
+        return 0;
+    }
+    // whole days, so the graph is compacted at most once a day of sails
+    int horizon = (latestEndMinute - retentionMinutes) / MINUTES_PER_DAY * MINUTES_PER_DAY;
+    if (horizon <= horizonMinute) {
+        return 0;
+    }
+    return compact(Date::fromMinutes(horizon));
+}
 
-    return outboundContainers;
+void ContainersGraph::restoreBaseline(PortId port, int balance, int inbound) {
+    reservePort(port);
+    timelines[port].addBaseline(balance, inbound);
 }
 
-int ContainersGraph::balance(const std::string &portName, const shared_ptr<Date> &date) {
+int ContainersGraph::balance(const std::string &portName, Date date) {
     auto port = findPortByName(portName);
-    if (port == nullptr) {
+    if (port == INVALID_PORT_ID) {
         throw PortNotExistsException(portName + " does not exists in database\n");
     }
+    checkHorizon(date);
 
-    // get all inbound and outbound containers occurred before the given date
-    auto inbound = inboundContainers(port, date);
-    auto outbound = outboundContainers(port, date);
+    // merge sails that were added since the last query into the port's timeline, published versions are flushed
+    auto& timeline = timelines[port];
+    timeline.flush();
 
-    // calculate the containers balance
-    int inboundBalance = 0;
-    int outboundBalance = 0;
+    // inbound containers that arrived minus outbound containers that departed until the given date
+    return timeline.balanceAt(date.toMinutes());
+}
+
+vector<pair<PortId, int>> ContainersGraph::balances(Date date) {
+    checkHorizon(date);
+    flushTimelines();
 
-    for (const auto& sail : inbound) {
-        const auto& containers = get<1>(sail);
-        inboundBalance += containers;
+    // every port's balance is a lookup in its own timeline, so one pass over the ports is enough
+    int minute = date.toMinutes();
+    vector<pair<PortId, int>> portsBalances;
+    for (PortId port = 0; port < ports.size(); port++) {
+        if (ports[port]) {
+            portsBalances.emplace_back(port, timelines[port].balanceAt(minute));
+        }
     }
+    return portsBalances;
+}
+
+PortsRanking ContainersGraph::top(Date date, size_t count) {
+    checkHorizon(date);
+    flushTimelines();
 
-    for (const auto& sail : outbound) {
-        const auto& containers = get<1>(sail);
-        outboundBalance += containers;
+    // per port aggregates, every one is a lookup in the port's timeline
+    int minute = date.toMinutes();
+    vector<pair<PortId, int>> portsBalances;
+    vector<pair<PortId, int>> portsInbound;
+    vector<pair<PortId, int>> portsOutbound;
+    for (PortId port = 0; port < ports.size(); port++) {
+        if (ports[port]) {
+            portsBalances.emplace_back(port, timelines[port].balanceAt(minute));
+            portsInbound.emplace_back(port, timelines[port].inboundAt(minute));
+            portsOutbound.emplace_back(port, timelines[port].outboundAt(minute));
+        }
     }
 
-    return inboundBalance - outboundBalance;
+    // select the top ports with a bounded heap instead of sorting all of them
+    auto selectTop = [count](const vector<pair<PortId, int>>& values, auto isBefore) {
+        vector<pair<PortId, int>> selected(min(count, values.size()));
+        partial_sort_copy(values.begin(), values.end(), selected.begin(), selected.end(),
+                          [&isBefore](const pair<PortId, int>& first, const pair<PortId, int>& second) {
+            if (first.second != second.second) {
+                return isBefore(first.second, second.second);
+            }
+            return first.first < second.first;
+        });
+        return selected;
+    };
 
+    PortsRanking ranking;
+    ranking.highestBalance = selectTop(portsBalances, greater<int>());
+    ranking.lowestBalance = selectTop(portsBalances, less<int>());
+    ranking.mostInbound = selectTop(portsInbound, greater<int>());
+    ranking.mostOutbound = selectTop(portsOutbound, greater<int>());
+    return ranking;
 }
 
-void ContainersGraph::print(std::ofstream &outStream) const {
+void ContainersGraph::flushTimelines() {
+    for (PortId port : dirtyPorts) {
+        timelines[port].flush();
+    }
+    dirtyPorts.clear();
+}
+
+void ContainersGraph::print(OutputWriter &out) const {
     // header
-    outStream << "Containers Graph Representation" << std::endl;
+    out << "Containers Graph Representation" << '\n';
 
     // sails
-    for (const auto& sailTuple : sails) {
-        const auto& srcPort = get<0>(sailTuple);
-        const auto& destPort = get<1>(sailTuple);
-        const auto& sailData = get<2>(sailTuple);
-
-        outStream << "* Sail from: " << srcPort->getName() << " (" << sailData->getStartDate()->getAsString() << ") to "
-                  << destPort->getName() << " (" << sailData->getEndDate()->getAsString() << ") with "
-                  <<sailData->getContainers() << " containers" << std::endl;
+    for (size_t sail = 0; sail < sails.size(); sail++) {
+        out << "* Sail from: " << portRegistry->getName(sails.getSrcPort(sail)) << " (" << sails.getStartDate(sail) << ") to "
+            << portRegistry->getName(sails.getDestPort(sail)) << " (" << sails.getEndDate(sail) << ") with "
+            << sails.getContainers(sail) << " containers" << '\n';
     }
 
     // separate break line
-    outStream << std::endl;
+    out << '\n';
 }
\ No newline at end of file
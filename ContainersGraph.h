@@ -7,58 +7,99 @@
 #include <unordered_set>
 #include <algorithm>
 #include "Port.h"
+#include "PortRegistry.h"
 #include "Date.h"
-#include "SailContainersData.h"
+#include "OutputWriter.h"
+#include "ContainersSails.h"
+#include "BalanceTimeline.h"
+#include "PortsRanking.h"
+#include "SailKey.h"
 using namespace std;
 
 /**
  * A class that represent the containers graph.
+ * The sails that end before the compaction horizon are folded into the baselines of their ports timelines and freed,
+ * so the queries from the horizon onward give the same answers while the graph keeps only the recent sails
+ * (and the 16 bytes key of every folded sail, so a folded sail that is added again isn't folded twice).
  */
 class ContainersGraph {
 private:
-    // vertexes
-    set<shared_ptr<Port>> ports;
-    // edges
-    vector<tuple<shared_ptr<Port>, shared_ptr<Port>, shared_ptr<SailContainersData>>> sails;
+    static constexpr int MINUTES_PER_DAY = 24 * 60;
 
-    /**
-     * Check if some sail (graph edge) is already exists.
-     * @param srcPort - sail's source port
-     * @param destPort - sail's destination port
-     * @param startDate - starting date of the sail
-     * @param endDate - ending date of the sail
-     * @return True if the given sail already exists, otherwise false.
-     */
-    bool sailExists(shared_ptr<Port> srcPort, shared_ptr<Port> destPort, shared_ptr<Date> startDate, shared_ptr<Date> endDate);
+    // ports names registry, shared with the times graph
+    shared_ptr<PortRegistry> portRegistry;
+    // vertexes, indexed by port id
+    vector<bool> ports;
+    // edges, in insertion order
+    ContainersSails sails;
+    // keys of all the edges, for duplicate sails detection
+    unordered_set<SailKey, SailKeyHash> sailsKeys;
+    // containers events timeline of every port, indexed by port id
+    vector<BalanceTimeline> timelines;
+    // ports that their timeline has events that were not flushed yet
+    vector<PortId> dirtyPorts;
+    // the sails that end before this minute were compacted, so queries can't ask about earlier times
+    int horizonMinute = 0;
+    // length of the history the automatic compaction keeps behind the latest sail, 0 to keep everything
+    int retentionMinutes = 0;
+    // end of the latest sail that was added
+    int latestEndMinute = 0;
+    // keys of the folded sails, sorted
+    vector<SailKey> foldedKeys;
 
     /**
      * Find a port vertex by name.
      * @param portName - the name of the port.
-     * @return Shared pointer to the found port object or nullptr if not found.
+     * @return The id of the found port or INVALID_PORT_ID if not found.
+     */
+    PortId findPortByName(const string& portName) const;
+
+    /**
+     * Make room for a port in the vertexes and timelines without adding it.
+     * @param port - id of the port
      */
-    shared_ptr<Port> findPortByName(const string& portName);
+    void reservePort(PortId port);
 
     /**
-     * Find all the inbound sails and their containers amount that occurred before some date.
-     * @param port - reference to the port.
-     * @param date - the date to get the inbounds before it.
-     * @return vector of tuples which contains the inbound sails and their container amount.
+     * Check that a query's date wasn't compacted.
+     * @param date - the query's date.
+     * @throws CompactedDateException - if the date is before the compaction horizon.
      */
-    vector<tuple<shared_ptr<Port>, int>> inboundContainers(const shared_ptr<Port>& port, const shared_ptr<Date>& date);
+    void checkHorizon(Date date) const;
 
     /**
-    * Find all the outbound sails and their containers amount that occurred before some date.
-    * @param port - reference to the port.
-    * @param date - the date to get the outbounds before it.
-    * @return vector of tuples which contains the outbound sails and their container amount.
-    */
-    vector<tuple<shared_ptr<Port>, int>> outboundContainers(const shared_ptr<Port>& port, const shared_ptr<Date>& date);
+     * Fold a sail that ends before the horizon and was added after the compaction into its ports baselines,
+     * unless it was folded already.
+     * @param key - the sail's key.
+     * @param containers - amount of containers on the sail.
+     * @return True if the sail was folded, false if it was folded already.
+     */
+    bool foldLateSail(const SailKey& key, int containers);
+
+    /**
+     * Add keys of folded sails to the sorted folded keys.
+     * @param keys - keys that are not folded yet.
+     */
+    void mergeFoldedKeys(vector<SailKey> keys);
 public:
+    /**
+     * Create an empty containers graph.
+     * @param portRegistry - ports names registry shared by the system graphs.
+     */
+    explicit ContainersGraph(shared_ptr<PortRegistry> portRegistry) : portRegistry(std::move(portRegistry)) {}
+
+    /**
+     * Copy the graph, so the copy can be modified while the graph is being read.
+     * @param portRegistry - ports names registry of the copy, must contain all the ports of the graph.
+     * @return The copy of the graph.
+     */
+    shared_ptr<ContainersGraph> clone(shared_ptr<PortRegistry> portRegistry) const;
+
     /**
      * Add a new port as vertex to the containers graph.
-     * @param port - port to add
+     * @param port - id of the port to add
      */
-    void addPort(shared_ptr<Port> port);
+    void addPort(PortId port);
 
     /**
      * Add a new sail as an edge to the containers graph.
@@ -68,22 +109,134 @@ public:
      * @param endDate - ending date of the sail
      * @param containers - amount of containers on the sail
      */
-    void addSail(shared_ptr<Port> srcPort, shared_ptr<Port> destPort, shared_ptr<Date> startDate, shared_ptr<Date> endDate, int containers);
+    void addSail(PortId srcPort, PortId destPort, Date startDate, Date endDate, int containers);
+
+    /**
+     * Add many sails at once, with the same result as adding them one by one in their order.
+     * The sails are radix sorted by their keys, so the duplicates are found in one linear pass instead of
+     * a lookup per sail, and the indexes are updated once for all the new sails.
+     * @param newSails - the sails to add, in the order they would be added one by one.
+     */
+    void addSails(const ContainersSails& newSails);
+
+    /**
+     * Fold all the sails that end before a horizon into their ports baselines and free them.
+     * The queries from the horizon onward are not affected, and earlier dates can't be queried anymore.
+     * Sails that end before the horizon and are added later are folded right away, unless they were folded already,
+     * so reloading a file doesn't count them twice.
+     * @param horizon - the compaction horizon, ignored if it's not after the current horizon.
+     * @return Amount of the freed sails.
+     */
+    size_t compact(Date horizon);
+
+    /**
+     * Compact automatically whenever the latest sail gets more than some days ahead of the horizon.
+     * @param retentionDays - amount of whole days to keep behind the latest sail, 0 to never compact.
+     */
+    void setRetention(int retentionDays) { retentionMinutes = retentionDays * MINUTES_PER_DAY; }
+
+    /**
+     * Compact to the beginning of the day that is the retention before the latest sail's end, if a retention was set.
+     * @return Amount of the freed sails.
+     */
+    size_t applyRetention();
+
+    /**
+     * Restore a compaction, as saved in a snapshot.
+     * @param horizon - the compaction horizon.
+     */
+    void restoreHorizon(Date horizon) { horizonMinute = max(horizonMinute, horizon.toMinutes()); }
+
+    /**
+     * Restore the baseline of a port, as saved in a snapshot.
+     * @param port - id of the port.
+     * @param balance - the port's balance of the compacted sails.
+     * @param inbound - amount of containers the compacted sails brought to the port.
+     */
+    void restoreBaseline(PortId port, int balance, int inbound);
+
+    /**
+     * Restore the keys of the folded sails, as saved in a snapshot.
+     * @param keys - keys of folded sails, in any order.
+     */
+    void restoreFoldedKeys(vector<SailKey> keys) { mergeFoldedKeys(std::move(keys)); }
 
     /**
      * Get the containers balance of a given port at specific date.
      * @param date - date of the desire balance value
      * @param portName - the name of the port.
      * @throws PortNotExistsException - if there's no port with the given name.
+     * @throws CompactedDateException - if the date is before the compaction horizon.
      * @return The desired balance value of the given port at the specific date.
      */
-    int balance(const string& portName, const shared_ptr<Date>& date);
+    int balance(const string& portName, Date date);
+
+    /**
+     * Get the containers balance of every port of the graph at specific date.
+     * @param date - date of the desire balance values
+     * @throws CompactedDateException - if the date is before the compaction horizon.
+     * @return (port id, balance) pairs of all the graph's ports, ordered by port id.
+     */
+    vector<pair<PortId, int>> balances(Date date);
+
+    /**
+     * Rank the ports of the graph at specific date by their balance and their inbound / outbound containers volume.
+     * @param date - date of the ranking.
+     * @param count - the maximal amount of ports in every list.
+     * @throws CompactedDateException - if the date is before the compaction horizon.
+     * @return The top ports by every criteria, ties are ordered by port id.
+     */
+    PortsRanking top(Date date, size_t count);
+
+    /**
+     * Flush the pending events of all the ports timelines.
+     * Afterward the queries don't modify the graph until the next sail is added,
+     * so they can be called from several threads concurrently.
+     */
+    void flushTimelines();
+
+    /**
+     * Print representation of the containers graph into a given writer.
+     * @param out - reference for the output writer
+     */
+    void print(OutputWriter& out) const;
+
+    /**
+     * @param port - id of the port.
+     * @return True if the port is a vertex of the graph, otherwise false.
+     */
+    bool hasPort(PortId port) const { return port < ports.size() && ports[port]; }
+
+    /**
+     * @return The ports names registry used by the graph.
+     */
+    const shared_ptr<PortRegistry>& getPortRegistry() const { return portRegistry; }
+
+    /**
+     * @return The compaction horizon, the beginning of the year if the graph was never compacted.
+     */
+    Date getHorizon() const { return Date::fromMinutes(horizonMinute); }
+
+    /**
+     * @return Keys of the sails that were folded into the baselines, sorted.
+     */
+    const vector<SailKey>& getFoldedKeys() const { return foldedKeys; }
+
+    /**
+     * @param port - id of the port.
+     * @return The port's (balance, inbound containers) of the compacted sails.
+     */
+    pair<int, int> getBaseline(PortId port) const {
+        if (port >= timelines.size()) {
+            return {0, 0};
+        }
+        return {timelines[port].getBaselineBalance(), timelines[port].getBaselineInbound()};
+    }
 
     /**
-     * Print representation of the containers graph into a given stream.
-     * @param outStream - reference for the output file stream
+     * @return The graph's edges, in insertion order.
      */
-    void print(ofstream& outStream) const;
+    const ContainersSails& getSails() const { return sails; }
 };
 
 
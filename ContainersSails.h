@@ -0,0 +1,70 @@
+#ifndef HW2_CONTAINERSSAILS_H
+#define HW2_CONTAINERSSAILS_H
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include "Port.h"
+#include "Date.h"
+#include "ColumnGrowth.h"
+using namespace std;
+
+/**
+ * A class that stores the containers graph's edges as parallel columns, one value per sail in every column.
+ * A sail takes 20 bytes with no heap objects of its own, and a scan over one field reads only that field's column.
+ * The dates are kept as minutes since the beginning of the year, so the columns can be scanned as plain integers.
+ */
+class ContainersSails {
+private:
+    vector<PortId> srcPorts;
+    vector<PortId> destPorts;
+    vector<int> startMinutes;
+    vector<int> endMinutes;
+    vector<int> containers;
+public:
+    /**
+     * Add a sail after the stored sails.
+     * @param srcPort - sail's source port
+     * @param destPort - sail's destination port
+     * @param startDate - starting date of the sail
+     * @param endDate - ending date of the sail
+     * @param sailContainers - amount of containers on the sail
+     */
+    void push_back(PortId srcPort, PortId destPort, Date startDate, Date endDate, int sailContainers) {
+        srcPorts.push_back(srcPort);
+        destPorts.push_back(destPort);
+        startMinutes.push_back(startDate.toMinutes());
+        endMinutes.push_back(endDate.toMinutes());
+        containers.push_back(sailContainers);
+    }
+
+    /**
+     * Make room for more sails, so adding them reallocates the columns at most once.
+     * @param count - amount of sails to make room for, besides the stored ones.
+     */
+    void reserveMore(size_t count) {
+        ColumnGrowth::reserveMore(count, srcPorts, destPorts, startMinutes, endMinutes, containers);
+    }
+
+    /**
+     * @return The amount of stored sails.
+     */
+    size_t size() const { return srcPorts.size(); }
+
+    PortId getSrcPort(size_t sail) const { return srcPorts[sail]; }
+    PortId getDestPort(size_t sail) const { return destPorts[sail]; }
+    Date getStartDate(size_t sail) const { return Date::fromMinutes(startMinutes[sail]); }
+    Date getEndDate(size_t sail) const { return Date::fromMinutes(endMinutes[sail]); }
+    int getContainers(size_t sail) const { return containers[sail]; }
+
+    /**
+     * The whole columns, indexed by sail.
+     */
+    const vector<PortId>& getSrcPorts() const { return srcPorts; }
+    const vector<PortId>& getDestPorts() const { return destPorts; }
+    const vector<int>& getStartMinutes() const { return startMinutes; }
+    const vector<int>& getEndMinutes() const { return endMinutes; }
+    const vector<int>& getContainers() const { return containers; }
+};
+
+
+#endif //HW2_CONTAINERSSAILS_H
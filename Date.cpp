@@ -1,52 +1,46 @@
 #include "Date.h"
-#include <sstream>
-#include <iomanip>
 #include "DateFormatException.h"
 
-Date::Date(std::string stringDate) : stringDate(std::move(stringDate)) {
-    char slash, colon;
-    std::istringstream ss(this->stringDate);
-
-    ss >> std::setw(2) >> this->day >> slash
-       >> std::setw(2) >> this->month;
-
-    if (ss.fail() || slash != '/') {
-        throw DateFormatException("");
-    }
-
-    ss.ignore(1); // skip the space
-
-    ss >> std::setw(2) >> this->hour >> colon
-       >> std::setw(2) >> this->minute;
-
-    if (ss.fail() || colon != ':') {
-        throw DateFormatException("");
-    }
-
-    // Check for extra characters
-    char extra;
-    if (ss >> extra) {
+Date::Date(std::string_view stringDate) : minutes(0) {
+    if (!tryParse(stringDate, *this)) {
         throw DateFormatException("");
     }
 }
 
-int Date::toMinutes() const {
-    const int daysInMonthAt2023[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-    int totalDays = 0;
+size_t Date::format(char *buffer) const {
+    int totalDays = minutes / (24 * 60);
+    int hour = (minutes / 60) % 24;
+    int minute = minutes % 60;
 
-    for (int i = 0; i < month - 1; ++i) {
-        totalDays += daysInMonthAt2023[i];
+    int month = 0;
+    while (month < 11 && totalDays >= DAYS_IN_MONTH_AT_2023[month]) {
+        totalDays -= DAYS_IN_MONTH_AT_2023[month];
+        month++;
     }
-
-    totalDays += (day - 1);
-
-    return totalDays * 24 * 60 + hour * 60 + minute;
+    int day = totalDays + 1;
+    month++;
+
+    buffer[0] = static_cast<char>('0' + day / 10);
+    buffer[1] = static_cast<char>('0' + day % 10);
+    buffer[2] = '/';
+    buffer[3] = static_cast<char>('0' + month / 10);
+    buffer[4] = static_cast<char>('0' + month % 10);
+    buffer[5] = ' ';
+    buffer[6] = static_cast<char>('0' + hour / 10);
+    buffer[7] = static_cast<char>('0' + hour % 10);
+    buffer[8] = ':';
+    buffer[9] = static_cast<char>('0' + minute / 10);
+    buffer[10] = static_cast<char>('0' + minute % 10);
+    return STRING_LENGTH;
 }
 
-int Date::minutesSince(std::shared_ptr<Date> other) const {
-    return this->toMinutes() - other->toMinutes();
+std::string Date::getAsString() const {
+    char buffer[STRING_LENGTH];
+    return {buffer, format(buffer)};
 }
 
-std::string Date::getAsString() const {
-    return this->stringDate;
-}
\ No newline at end of file
+// the parser is usable at compile time
+static_assert([] {
+    Date date;
+    return Date::tryParse("02/01 01:05", date) && date.toMinutes() == 24 * 60 + 65;
+}());
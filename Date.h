@@ -1,25 +1,136 @@
 #ifndef HW2_DATE_H
 #define HW2_DATE_H
 #include <iostream>
-#include <memory>
+#include <string_view>
+#include <compare>
+#include <type_traits>
 
 /**
  * This class represent a date object in my project.
  * We assume that all the dates in the project are on the same year.
+ * A date is stored as the amount of minutes since the beginning of the year, so it's cheap to copy and compare.
  */
 class Date {
 private:
-    std::string stringDate;
-    int day;
-    int month;
-    int hour;
-    int minute;
+    // minutes since 01/01 00:00
+    int minutes;
+
+    static constexpr int DAYS_IN_MONTH_AT_2023[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+    /**
+     * Parse a number of one or two digits.
+     * @param text - the text to parse.
+     * @param pos - position of the number in the text, moved past the number.
+     * @param value - the parsed number.
+     * @return True if a number was parsed, otherwise false.
+     */
+    static constexpr bool parseNumber(std::string_view text, size_t& pos, int& value) {
+        size_t start = pos;
+        value = 0;
+        while (pos < text.size() && pos - start < 2 && text[pos] >= '0' && text[pos] <= '9') {
+            value = value * 10 + (text[pos] - '0');
+            pos++;
+        }
+        return pos > start;
+    }
+
+    /**
+     * Check that the next character of the text is the expected separator.
+     * @param text - the text to parse.
+     * @param pos - position of the separator in the text, moved past the separator.
+     * @param separator - the expected separator.
+     * @return True if the separator was found, otherwise false.
+     */
+    static constexpr bool parseSeparator(std::string_view text, size_t& pos, char separator) {
+        if (pos >= text.size() || text[pos] != separator) {
+            return false;
+        }
+        pos++;
+        return true;
+    }
 public:
-    explicit Date(std::string stringDate);
-    int toMinutes() const;
-    int minutesSince(std::shared_ptr<Date> other) const;
+    // length of the "dd/mm HH:mm" text representation
+    static constexpr size_t STRING_LENGTH = 11;
+
+    constexpr Date() : minutes(0) {}
+
+    /**
+     * Create a date from its "dd/mm HH:mm" text representation.
+     * @param stringDate - the date's text.
+     * @throws DateFormatException - if the text is not a valid date.
+     */
+    explicit Date(std::string_view stringDate);
+
+    /**
+     * Parse a "dd/mm HH:mm" text into a date, without throwing.
+     * @param text - the date's text.
+     * @param date - the parsed date.
+     * @return True if the text is a valid date, otherwise false.
+     */
+    static constexpr bool tryParse(std::string_view text, Date& date) {
+        size_t pos = 0;
+        int day = 0, month = 0, hour = 0, minute = 0;
+
+        // allow leading whitespaces
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t')) {
+            pos++;
+        }
+
+        if (!parseNumber(text, pos, day) || !parseSeparator(text, pos, '/') || !parseNumber(text, pos, month)
+            || !parseSeparator(text, pos, ' ') || !parseNumber(text, pos, hour) || !parseSeparator(text, pos, ':')
+            || !parseNumber(text, pos, minute)) {
+            return false;
+        }
+
+        // allow trailing whitespaces only
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t')) {
+            pos++;
+        }
+        if (pos != text.size()) {
+            return false;
+        }
+
+        if (month < 1 || month > 12 || day < 1 || day > DAYS_IN_MONTH_AT_2023[month - 1] || hour > 23 || minute > 59) {
+            return false;
+        }
+
+        int totalDays = day - 1;
+        for (int i = 0; i < month - 1; ++i) {
+            totalDays += DAYS_IN_MONTH_AT_2023[i];
+        }
+
+        date.minutes = totalDays * 24 * 60 + hour * 60 + minute;
+        return true;
+    }
+
+    /**
+     * Create a date from an amount of minutes since the beginning of the year.
+     * @param minutes - minutes since 01/01 00:00.
+     * @return The matching date.
+     */
+    static constexpr Date fromMinutes(int minutes) {
+        Date date;
+        date.minutes = minutes;
+        return date;
+    }
+
+    constexpr int toMinutes() const { return minutes; }
+    constexpr int minutesSince(Date other) const { return minutes - other.minutes; }
+
+    /**
+     * Write the "dd/mm HH:mm" text representation of the date into a buffer.
+     * @param buffer - buffer with room for at least STRING_LENGTH characters.
+     * @return The amount of characters written.
+     */
+    size_t format(char* buffer) const;
+
     std::string getAsString() const;
+
+    constexpr auto operator<=>(const Date& other) const = default;
 };
 
+static_assert(sizeof(Date) == 4, "Date should stay a 4 bytes value type");
+static_assert(std::is_trivially_copyable_v<Date>, "Date should be trivially copyable");
+
 
 #endif //HW2_DATE_H
@@ -0,0 +1,111 @@
+#include "FeedFollower.h"
+#include "FileErrorException.h"
+#include "CommandStats.h"
+#include "SystemUtils.h"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+FeedFollower::FeedFollower(string feedFilename) : feedFilename(std::move(feedFilename)) {
+    // non blocking, so opening a fifo doesn't wait for a writer and reading it doesn't wait for data
+    fd = open(this->feedFilename.c_str(), O_RDONLY | O_NONBLOCK);
+    if (fd < 0) {
+        throw FileErrorException(" ERROR opening/reading the specified file.");
+    }
+}
+
+FeedFollower::~FeedFollower() {
+    close(fd);
+}
+
+void FeedFollower::restart() {
+    lseek(fd, 0, SEEK_SET);
+    offset = 0;
+    partialLine.clear();
+    // the rows context is reset when the lines read until now are applied
+    restartPositions.push_back(pendingLines.size());
+}
+
+size_t FeedFollower::readNewLines() {
+    // a regular file that got shorter than what was read was truncated or replaced
+    struct stat feedStat{};
+    if (fstat(fd, &feedStat) == 0 && S_ISREG(feedStat.st_mode) && static_cast<uint64_t>(feedStat.st_size) < offset) {
+        cerr << "Feed " << feedFilename << " was truncated, following it from the beginning" << endl;
+        restart();
+    }
+
+    size_t pendingCount = pendingLines.size();
+    char buffer[1 << 16];
+    while (true) {
+        ssize_t bytesRead = read(fd, buffer, sizeof(buffer));
+        if (bytesRead <= 0) {
+            // end of the feed for now, no data in the fifo or a read error
+            break;
+        }
+        offset += static_cast<uint64_t>(bytesRead);
+
+        string_view chunk(buffer, static_cast<size_t>(bytesRead));
+        size_t lineStart = 0;
+        size_t lineEnd;
+        while ((lineEnd = chunk.find('\n', lineStart)) != string_view::npos) {
+            partialLine.append(chunk.substr(lineStart, lineEnd - lineStart));
+            pendingLines.push_back(std::move(partialLine));
+            partialLine.clear();
+            lineStart = lineEnd + 1;
+        }
+        partialLine.append(chunk.substr(lineStart));
+    }
+    return pendingLines.size() - pendingCount;
+}
+
+size_t FeedFollower::applyPendingLines(shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph,
+                                       ostream &err) {
+    auto& portRegistry = *timesGraph->getPortRegistry();
+    size_t appliedCount = 0;
+    size_t nextRestart = 0;
+    auto resetContext = [this]() {
+        lineNum = 0;
+        originPort = INVALID_PORT_ID;
+        previousPort = INVALID_PORT_ID;
+    };
+    for (size_t i = 0; i < pendingLines.size(); i++) {
+        for (; nextRestart < restartPositions.size() && restartPositions[nextRestart] == i; nextRestart++) {
+            resetContext();
+        }
+        const string& line = pendingLines[i];
+        size_t currentLineNum = lineNum++;
+        tuple<string_view, Date, Date, int> row;
+        bool isOriginLine = originPort == INVALID_PORT_ID;
+        if (!SystemUtils::parseInputLine(line, isOriginLine, row)) {
+            CommandStats::global().recordError(CommandError::INVALID_INPUT);
+            err << "Invalid input in file " << feedFilename << " at line " << currentLineNum + 1 << endl;
+            continue;
+        }
+        auto [portName, startTime, endTime, containers] = row;
+        PortId port = portRegistry.intern(portName);
+        containersGraph->addPort(port);
+        timesGraph->addPort(port);
+
+        if (isOriginLine) {
+            // the context of all the next rows
+            originPort = port;
+            originTime = startTime;
+            previousPort = port;
+            previousTime = startTime;
+        } else {
+            // the same sails a load of the whole file adds for this row
+            containersGraph->addSail(originPort, port, originTime, startTime, containers);
+            timesGraph->addSail(previousPort, port, previousTime, startTime);
+            previousPort = port;
+            previousTime = endTime;
+        }
+        appliedCount++;
+    }
+    if (nextRestart < restartPositions.size()) {
+        // restarted after the last pending line
+        resetContext();
+    }
+    pendingLines.clear();
+    restartPositions.clear();
+    return appliedCount;
+}
@@ -0,0 +1,92 @@
+#ifndef HW2_FEEDFOLLOWER_H
+#define HW2_FEEDFOLLOWER_H
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "ContainersGraph.h"
+#include "TimesGraph.h"
+#include "Port.h"
+#include "Date.h"
+using namespace std;
+
+/**
+ * A class that follows an input file (or a fifo) that rows are appended to over time.
+ * Every read continues from the byte offset where the previous one stopped, and every new row is applied to the graphs
+ * once, with the origin port of the feed's first line and the previous row as its context, just like a load of the
+ * whole file would apply it. A line is read only after its line break is written.
+ * The read lines wait in the follower until they're applied, so the rows of several reads can be applied together.
+ */
+class FeedFollower {
+private:
+    string feedFilename;
+    int fd;
+    // bytes of the feed that were read, including the unfinished last line
+    uint64_t offset = 0;
+    // the last line read without its line break yet
+    string partialLine;
+    // number of the next line of the feed, starting at 0
+    size_t lineNum = 0;
+    // origin port and departure time of the feed, from its first line
+    PortId originPort = INVALID_PORT_ID;
+    Date originTime;
+    // port of the previous row and the time the containers left it
+    PortId previousPort = INVALID_PORT_ID;
+    Date previousTime;
+    // lines that were read and not applied yet
+    vector<string> pendingLines;
+    // positions in the pending lines where the feed was followed from its beginning again,
+    // the rows from there on don't have the context of the earlier rows
+    vector<size_t> restartPositions;
+
+    /**
+     * Start following the feed from its beginning, after it was truncated or replaced.
+     */
+    void restart();
+public:
+    /**
+     * Open a feed for following, from its beginning.
+     * @param feedFilename - the name of the feed file.
+     * @throws FileErrorException - if the feed not found or failed to open.
+     */
+    explicit FeedFollower(string feedFilename);
+    ~FeedFollower();
+
+    FeedFollower(const FeedFollower&) = delete;
+    FeedFollower& operator=(const FeedFollower&) = delete;
+
+    /**
+     * Read the lines that were completed since the last read, and keep them until they're applied.
+     * @return Amount of the new lines.
+     */
+    size_t readNewLines();
+
+    /**
+     * @return True if there are lines that were read and not applied yet, otherwise false.
+     */
+    bool hasPendingLines() const { return !pendingLines.empty(); }
+
+    /**
+     * Add the rows of the pending lines to the transportation graphs, in their order.
+     * Invalid lines are reported and skipped.
+     * @param containersGraph - transportation containers graph.
+     * @param timesGraph - transportation times graph.
+     * @param err - stream to print the invalid lines into.
+     * @return Amount of the lines that were added.
+     */
+    size_t applyPendingLines(shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph, ostream& err);
+
+    /**
+     * @return Amount of the feed's bytes that were read.
+     */
+    uint64_t getOffset() const { return offset; }
+
+    /**
+     * @return The name of the feed file.
+     */
+    const string& getFilename() const { return feedFilename; }
+};
+
+
+#endif //HW2_FEEDFOLLOWER_H
@@ -0,0 +1,28 @@
+#include "GraphStore.h"
+
+GraphStore::GraphStore(shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph) {
+    publish(std::move(containersGraph), std::move(timesGraph), 0);
+}
+
+uint64_t GraphStore::reserveUpdate() {
+    lock_guard<mutex> lock(updateMutex);
+    return nextTicket++;
+}
+
+void GraphStore::finishTurn() {
+    servingTicket++;
+    turnChanged.notify_all();
+}
+
+void GraphStore::publish(shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph,
+                         uint64_t number) {
+    // the automatic compaction happens before the version is shared,
+    // the timetable follows the containers graph's horizon however it moved
+    containersGraph->applyRetention();
+    timesGraph->compactTimetable(containersGraph->getHorizon());
+    // the queries of a published version only read it
+    containersGraph->flushTimelines();
+    timesGraph->flushTimetable();
+    currentVersion.store(make_shared<const GraphVersion>(GraphVersion{std::move(containersGraph),
+                                                                      std::move(timesGraph), number}));
+}
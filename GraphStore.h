@@ -0,0 +1,124 @@
+#ifndef HW2_GRAPHSTORE_H
+#define HW2_GRAPHSTORE_H
+#include <iostream>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "ContainersGraph.h"
+#include "TimesGraph.h"
+#include "PortRegistry.h"
+using namespace std;
+
+/**
+ * A consistent version of the system graphs.
+ * A published version is never modified, so any amount of threads can query it.
+ */
+struct GraphVersion {
+    shared_ptr<ContainersGraph> containersGraph;
+    shared_ptr<TimesGraph> timesGraph;
+    // increases by one on every published update
+    uint64_t number;
+};
+
+/**
+ * A class that holds the current version of the system graphs.
+ * Readers take the current version without locking and keep using it as long as they need.
+ * An update copies the current version, modifies the copy aside and publishes it atomically,
+ * so readers never see a partial update and never wait for one. Updates are serialized in the order of their tickets,
+ * so updates that were requested one after another apply in that order even when they run on different threads.
+ */
+class GraphStore {
+private:
+    atomic<shared_ptr<const GraphVersion>> currentVersion;
+    // serializes the updates, so an update never misses the changes of another one
+    mutex updateMutex;
+    // notified when the next ticket's turn comes
+    condition_variable turnChanged;
+    // the ticket of the next requested update
+    uint64_t nextTicket = 0;
+    // the ticket of the update whose turn it is
+    uint64_t servingTicket = 0;
+
+    /**
+     * Prepare graphs to be published, and publish them as the current version.
+     * @param containersGraph - transportation containers graph.
+     * @param timesGraph - transportation times graph.
+     * @param number - number of the new version.
+     */
+    void publish(shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph, uint64_t number);
+
+    /**
+     * Pass the turn to the next ticket, with the update lock held.
+     */
+    void finishTurn();
+public:
+    /**
+     * Create a store with initial graphs. The graphs must not be modified afterward.
+     * @param containersGraph - initial transportation containers graph.
+     * @param timesGraph - initial transportation times graph, sharing the ports registry of the containers graph.
+     */
+    GraphStore(shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph);
+
+    /**
+     * @return The current version of the graphs.
+     */
+    shared_ptr<const GraphVersion> current() const { return currentVersion.load(); }
+
+    /**
+     * Take the turn of an update that will run later, possibly on another thread.
+     * Every ticket must be passed to update exactly once, the updates of the later tickets wait for it.
+     * @return The ticket of the update.
+     */
+    uint64_t reserveUpdate();
+
+    /**
+     * Modify a copy of the current graphs and publish it as the new current version, after the updates whose
+     * tickets were reserved before.
+     * @param ticket - the update's ticket, from reserveUpdate.
+     * @param update - callable that gets the copies of the containers and times graphs, modifies them
+     * and returns true if the copies should be published.
+     * @return The value returned from the update.
+     */
+    template<typename Update>
+    bool update(uint64_t ticket, Update update) {
+        unique_lock<mutex> lock(updateMutex);
+        turnChanged.wait(lock, [this, ticket]() { return servingTicket == ticket; });
+        auto base = currentVersion.load();
+
+        bool published;
+        try {
+            // the graphs share their ports registry, so the copies share a copy of it
+            auto portRegistry = make_shared<PortRegistry>(*base->timesGraph->getPortRegistry());
+            auto containersGraph = base->containersGraph->clone(portRegistry);
+            auto timesGraph = base->timesGraph->clone(portRegistry);
+
+            published = update(containersGraph, timesGraph);
+            if (published) {
+                publish(std::move(containersGraph), std::move(timesGraph), base->number + 1);
+            }
+        } catch (...) {
+            // the next updates still get their turn
+            finishTurn();
+            throw;
+        }
+        finishTurn();
+        return published;
+    }
+
+    /**
+     * Modify a copy of the current graphs and publish it as the new current version, after the updates that were
+     * requested before.
+     * @param update - callable that gets the copies of the containers and times graphs, modifies them
+     * and returns true if the copies should be published.
+     * @return The value returned from the update.
+     */
+    template<typename Update>
+    bool update(Update update) {
+        return this->update(reserveUpdate(), std::move(update));
+    }
+};
+
+
+#endif //HW2_GRAPHSTORE_H
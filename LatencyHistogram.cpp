@@ -0,0 +1,37 @@
+#include "LatencyHistogram.h"
+#include <bit>
+#include <cmath>
+#include <algorithm>
+
+void LatencyHistogram::record(uint64_t nanoseconds) {
+    // the bucket is the position of the highest set bit
+    size_t bucket = nanoseconds == 0 ? 0 : static_cast<size_t>(bit_width(nanoseconds)) - 1;
+    buckets[min(bucket, BUCKETS_COUNT - 1)].fetch_add(1, memory_order_relaxed);
+    count.fetch_add(1, memory_order_relaxed);
+
+    uint64_t currentMax = maxNanoseconds.load(memory_order_relaxed);
+    while (nanoseconds > currentMax && !maxNanoseconds.compare_exchange_weak(currentMax, nanoseconds, memory_order_relaxed)) {
+        // another thread changed the maximum, currentMax was reloaded
+    }
+}
+
+uint64_t LatencyHistogram::percentile(double percentile) const {
+    uint64_t total = getCount();
+    if (total == 0) {
+        return 0;
+    }
+
+    // rank of the percentile's duration, 1 based
+    auto rank = static_cast<uint64_t>(ceil(percentile / 100 * static_cast<double>(total)));
+    rank = clamp<uint64_t>(rank, 1, total);
+
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < BUCKETS_COUNT; bucket++) {
+        seen += buckets[bucket].load(memory_order_relaxed);
+        if (seen >= rank) {
+            uint64_t upperBound = (uint64_t(1) << (bucket + 1)) - 1;
+            return min(upperBound, getMax());
+        }
+    }
+    return getMax();
+}
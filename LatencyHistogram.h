@@ -0,0 +1,48 @@
+#ifndef HW2_LATENCYHISTOGRAM_H
+#define HW2_LATENCYHISTOGRAM_H
+#include <iostream>
+#include <array>
+#include <atomic>
+#include <cstdint>
+using namespace std;
+
+/**
+ * A class that counts durations in buckets of powers of two nanoseconds.
+ * Recording is a few relaxed atomic increments, so several threads can record into the same histogram.
+ * Percentiles are approximated by the upper bound of their bucket.
+ */
+class LatencyHistogram {
+public:
+    // bucket i counts the durations in [2^i, 2^(i+1)) nanoseconds, the last one counts all the longer durations
+    static constexpr size_t BUCKETS_COUNT = 48;
+private:
+    array<atomic<uint64_t>, BUCKETS_COUNT> buckets{};
+    atomic<uint64_t> count{0};
+    atomic<uint64_t> maxNanoseconds{0};
+public:
+    /**
+     * Record a single duration.
+     * @param nanoseconds - the duration in nanoseconds.
+     */
+    void record(uint64_t nanoseconds);
+
+    /**
+     * @return Amount of the recorded durations.
+     */
+    uint64_t getCount() const { return count.load(memory_order_relaxed); }
+
+    /**
+     * @return The longest recorded duration in nanoseconds.
+     */
+    uint64_t getMax() const { return maxNanoseconds.load(memory_order_relaxed); }
+
+    /**
+     * Get an upper bound of a percentile of the recorded durations.
+     * @param percentile - the percentile, between 0 and 100.
+     * @return Upper bound of the percentile in nanoseconds (never more than the longest duration), 0 if empty.
+     */
+    uint64_t percentile(double percentile) const;
+};
+
+
+#endif //HW2_LATENCYHISTOGRAM_H
@@ -0,0 +1,73 @@
+#include "MappedFile.h"
+#include "FileErrorException.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string &filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw FileErrorException(" ERROR opening/reading the specified file.");
+    }
+
+    struct stat fileStat{};
+    if (fstat(fd, &fileStat) < 0) {
+        close(fd);
+        throw FileErrorException(" ERROR opening/reading the specified file.");
+    }
+
+    if (S_ISREG(fileStat.st_mode) && fileStat.st_size > 0) {
+        void* mapping = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            madvise(mapping, fileStat.st_size, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(mapping);
+            size = fileStat.st_size;
+            mapped = true;
+            close(fd);
+            return;
+        }
+    }
+
+    // not a mappable file, read it into memory
+    char chunk[1 << 16];
+    ssize_t bytesRead;
+    while ((bytesRead = read(fd, chunk, sizeof(chunk))) > 0) {
+        buffer.insert(buffer.end(), chunk, chunk + bytesRead);
+    }
+    close(fd);
+    if (bytesRead < 0) {
+        throw FileErrorException(" ERROR opening/reading the specified file.");
+    }
+    data = buffer.data();
+    size = buffer.size();
+}
+
+MappedFile::~MappedFile() {
+    if (mapped) {
+        munmap(const_cast<char*>(data), size);
+    }
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+        : data(other.data), size(other.size), mapped(other.mapped), buffer(std::move(other.buffer)) {
+    other.data = nullptr;
+    other.size = 0;
+    other.mapped = false;
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+        if (mapped) {
+            munmap(const_cast<char*>(data), size);
+        }
+        data = other.data;
+        size = other.size;
+        mapped = other.mapped;
+        buffer = std::move(other.buffer);
+        other.data = nullptr;
+        other.size = 0;
+        other.mapped = false;
+    }
+    return *this;
+}
@@ -0,0 +1,41 @@
+#ifndef HW2_MAPPEDFILE_H
+#define HW2_MAPPEDFILE_H
+#include <iostream>
+#include <string_view>
+#include <vector>
+using namespace std;
+
+/**
+ * A class that maps a whole file into memory for reading.
+ * The contents stay valid as long as the object is alive.
+ * Files that can't be mapped (pipes, character devices) are read into memory instead.
+ */
+class MappedFile {
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+    // true if data points to a memory mapping, otherwise it points into buffer
+    bool mapped = false;
+    vector<char> buffer;
+public:
+    /**
+     * Map a file into memory.
+     * @param filename - the name of the file to map.
+     * @throws FileErrorException - if the file not found or failed to open / read.
+     */
+    explicit MappedFile(const string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @return View of the whole file contents.
+     */
+    string_view getContents() const { return {data, size}; }
+};
+
+
+#endif //HW2_MAPPEDFILE_H
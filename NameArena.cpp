@@ -0,0 +1,21 @@
+#include "NameArena.h"
+#include <cstring>
+#include <algorithm>
+
+string_view NameArena::store(std::string_view text) {
+    if (text.size() > chunkRemaining) {
+        // strings longer than a chunk get a chunk of their own
+        size_t chunkSize = max(CHUNK_SIZE, text.size());
+        chunks.push_back(make_unique_for_overwrite<char[]>(chunkSize));
+        nextFree = chunks.back().get();
+        chunkRemaining = chunkSize;
+    }
+
+    char* stored = nextFree;
+    if (!text.empty()) {
+        memcpy(stored, text.data(), text.size());
+    }
+    nextFree += text.size();
+    chunkRemaining -= text.size();
+    return {stored, text.size()};
+}
@@ -0,0 +1,36 @@
+#ifndef HW2_NAMEARENA_H
+#define HW2_NAMEARENA_H
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <string_view>
+using namespace std;
+
+/**
+ * A class that stores strings back to back in large chunks.
+ * Stored strings never move, so views of them stay valid until the arena is destroyed,
+ * and all of them are released together with the arena.
+ */
+class NameArena {
+private:
+    static constexpr size_t CHUNK_SIZE = 1 << 14;
+
+    vector<unique_ptr<char[]>> chunks;
+    // free room at the end of the last chunk
+    char* nextFree = nullptr;
+    size_t chunkRemaining = 0;
+public:
+    NameArena() = default;
+    NameArena(const NameArena& other) = delete;
+    NameArena& operator=(const NameArena& other) = delete;
+
+    /**
+     * Copy a string into the arena.
+     * @param text - the string to copy.
+     * @return View of the stored copy.
+     */
+    string_view store(string_view text);
+};
+
+
+#endif //HW2_NAMEARENA_H
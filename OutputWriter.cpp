@@ -0,0 +1,13 @@
+#include "OutputWriter.h"
+
+void OutputWriter::drain() {
+    if (used > 0) {
+        stream.write(buffer.data(), static_cast<streamsize>(used));
+        used = 0;
+    }
+}
+
+void OutputWriter::flush() {
+    drain();
+    stream.flush();
+}
@@ -0,0 +1,90 @@
+#ifndef HW2_OUTPUTWRITER_H
+#define HW2_OUTPUTWRITER_H
+#include <iostream>
+#include <string_view>
+#include <vector>
+#include <charconv>
+#include <concepts>
+#include "Date.h"
+using namespace std;
+
+/**
+ * A class that buffers text output before writing it into a stream.
+ * Numbers and dates are formatted directly into the buffer, and the stream is flushed
+ * only when flush is called (the buffer is written out earlier if it fills up).
+ */
+class OutputWriter {
+private:
+    ostream& stream;
+    vector<char> buffer;
+    size_t used = 0;
+
+    /**
+     * Write the buffered text into the stream, without flushing the stream.
+     */
+    void drain();
+
+    /**
+     * Make room for some characters in the buffer.
+     * @param length - amount of characters to make room for.
+     * @return Pointer to the free room.
+     */
+    char* reserve(size_t length) {
+        if (used + length > buffer.size()) {
+            drain();
+            if (length > buffer.size()) {
+                buffer.resize(length);
+            }
+        }
+        return buffer.data() + used;
+    }
+public:
+    /**
+     * Create a writer over a stream.
+     * @param stream - the stream to write into.
+     * @param capacity - the size of the buffer.
+     */
+    explicit OutputWriter(ostream& stream, size_t capacity = 1 << 16) : stream(stream), buffer(capacity) {}
+
+    /**
+     * Write the remaining buffered text and flush the stream.
+     */
+    ~OutputWriter() { flush(); }
+
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    OutputWriter& operator<<(string_view text) {
+        char* position = reserve(text.size());
+        text.copy(position, text.size());
+        used += text.size();
+        return *this;
+    }
+
+    OutputWriter& operator<<(char ch) {
+        *reserve(1) = ch;
+        used++;
+        return *this;
+    }
+
+    template<integral Integer>
+    OutputWriter& operator<<(Integer value) {
+        // enough for any 64 bits integer with its sign
+        char* position = reserve(21);
+        used = to_chars(position, position + 21, value).ptr - buffer.data();
+        return *this;
+    }
+
+    OutputWriter& operator<<(Date date) {
+        used += date.format(reserve(Date::STRING_LENGTH));
+        return *this;
+    }
+
+    /**
+     * Write the buffered text into the stream and flush it.
+     */
+    void flush();
+};
+
+
+#endif //HW2_OUTPUTWRITER_H
@@ -1,15 +1,24 @@
 #ifndef HW2_PORT_H
 #define HW2_PORT_H
 #include <iostream>
+#include <cstdint>
+#include <string_view>
+
+// dense port identifier assigned by the port registry
+using PortId = uint32_t;
+const PortId INVALID_PORT_ID = UINT32_MAX;
 
 class Port {
 private:
-    std::string name;
+    PortId id;
+    // view of the name stored by the port registry
+    std::string_view name;
 public:
-    explicit Port(std::string name) : name(std::move(name)) {}
-    std::string getName() const { return name; }
+    Port(PortId id, std::string_view name) : id(id), name(name) {}
+    PortId getId() const { return id; }
+    std::string_view getName() const { return name; }
     bool operator==(const Port& other) const {
-        return this->name == other.name;
+        return this->id == other.id;
     }
 };
 
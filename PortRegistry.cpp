@@ -0,0 +1,31 @@
+#include "PortRegistry.h"
+
+PortRegistry::PortRegistry(const PortRegistry &other) {
+    ports.reserve(other.ports.size());
+    idsByName.reserve(other.idsByName.size());
+    for (const Port& port : other.ports) {
+        intern(port.getName());
+    }
+}
+
+PortId PortRegistry::intern(std::string_view portName) {
+    auto found = idsByName.find(portName);
+    if (found != idsByName.end()) {
+        return found->second;
+    }
+
+    // first time we see this port
+    auto portId = static_cast<PortId>(ports.size());
+    string_view storedName = names.store(portName);
+    ports.emplace_back(portId, storedName);
+    idsByName.emplace(storedName, portId);
+    return portId;
+}
+
+PortId PortRegistry::find(std::string_view portName) const {
+    auto found = idsByName.find(portName);
+    if (found == idsByName.end()) {
+        return INVALID_PORT_ID;
+    }
+    return found->second;
+}
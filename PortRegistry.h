@@ -0,0 +1,72 @@
+#ifndef HW2_PORTREGISTRY_H
+#define HW2_PORTREGISTRY_H
+#include <iostream>
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <string_view>
+#include "Port.h"
+#include "NameArena.h"
+using namespace std;
+
+/**
+ * A class that interns port names into dense integer ids.
+ * The registry is shared by the containers and times graphs, so the same port name
+ * always maps to the same id and the graphs can compare ports by id only.
+ * The names are stored once in an arena, and the ports and the lookup table refer to them by views.
+ */
+class PortRegistry {
+private:
+    // storage of the ports names
+    NameArena names;
+    // interned ports, indexed by their id
+    vector<Port> ports;
+    // port ids by port name
+    unordered_map<string_view, PortId> idsByName;
+public:
+    PortRegistry() = default;
+
+    /**
+     * Copy the ports of another registry with the same ids, into a names arena of its own.
+     * @param other - the registry to copy.
+     */
+    PortRegistry(const PortRegistry& other);
+
+    PortRegistry& operator=(const PortRegistry& other) = delete;
+
+    /**
+     * Get the id of a port, registering it if it's seen for the first time.
+     * @param portName - the name of the port.
+     * @return The id of the port.
+     */
+    PortId intern(string_view portName);
+
+    /**
+     * Find the id of an already registered port.
+     * @param portName - the name of the port.
+     * @return The id of the port or INVALID_PORT_ID if not registered.
+     */
+    PortId find(string_view portName) const;
+
+    /**
+     * Get a registered port by its id.
+     * @param portId - the id of the port.
+     * @return Reference to the registered port.
+     */
+    const Port& getPort(PortId portId) const { return ports[portId]; }
+
+    /**
+     * Get the name of a registered port by its id.
+     * @param portId - the id of the port.
+     * @return View of the port's name, valid as long as the registry exists.
+     */
+    string_view getName(PortId portId) const { return ports[portId].getName(); }
+
+    /**
+     * @return The amount of registered ports.
+     */
+    size_t size() const { return ports.size(); }
+};
+
+
+#endif //HW2_PORTREGISTRY_H
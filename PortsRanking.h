@@ -0,0 +1,24 @@
+#ifndef HW2_PORTSRANKING_H
+#define HW2_PORTSRANKING_H
+#include <iostream>
+#include <vector>
+#include "Port.h"
+using namespace std;
+
+/**
+ * The top ports of the containers graph at some date, by several criteria.
+ * Every list holds (port id, value) pairs, ordered from the top port down.
+ */
+struct PortsRanking {
+    // ports with the most containers
+    vector<pair<PortId, int>> highestBalance;
+    // ports with the biggest containers deficit
+    vector<pair<PortId, int>> lowestBalance;
+    // ports that received the most containers
+    vector<pair<PortId, int>> mostInbound;
+    // ports that sent the most containers
+    vector<pair<PortId, int>> mostOutbound;
+};
+
+
+#endif //HW2_PORTSRANKING_H
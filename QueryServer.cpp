@@ -0,0 +1,399 @@
+#include "QueryServer.h"
+#include "FileErrorException.h"
+#include "Commands.h"
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+namespace {
+    // epoll data of the non client descriptors, client connections ids start at 1
+    constexpr uint64_t LISTEN_ID = 0;
+    constexpr uint64_t WAKEUP_ID = UINT64_MAX;
+
+    // set by the signal handler, the server's eventfd is written to wake it up
+    volatile sig_atomic_t stopRequested = 0;
+    int signalWakeupFd = -1;
+
+    void requestStop(int) {
+        stopRequested = 1;
+        uint64_t one = 1;
+        if (signalWakeupFd >= 0) {
+            ssize_t ignored = write(signalWakeupFd, &one, sizeof(one));
+            (void) ignored;
+        }
+    }
+
+    constexpr unsigned long MAX_PORT_NUMBER = 65535;
+
+    /**
+     * @param text - the text to check.
+     * @return True if the text is a non-empty decimal number, otherwise false.
+     */
+    bool isNumber(const string& text) {
+        return !text.empty() && all_of(text.begin(), text.end(), [](unsigned char ch) {
+            return isdigit(ch);
+        });
+    }
+}
+
+QueryServer::Wakeup::~Wakeup() {
+    if (eventFd >= 0) {
+        close(eventFd);
+    }
+}
+
+void QueryServer::Wakeup::notify(uint64_t connectionId) {
+    {
+        lock_guard<mutex> lock(readyMutex);
+        readyConnections.push_back(connectionId);
+    }
+    uint64_t one = 1;
+    ssize_t ignored = write(eventFd, &one, sizeof(one));
+    (void) ignored;
+}
+
+void QueryServer::Reply::send(string text) const {
+    // the response must not end with an empty line of its own, since an empty line ends it
+    while (!text.empty() && text.back() == '\n') {
+        text.pop_back();
+    }
+    if (!text.empty()) {
+        text += '\n';
+    }
+
+    lock_guard<mutex> lock(state->replyMutex);
+    state->text = std::move(text);
+    state->done = true;
+    if (state->waited) {
+        state->wakeup->notify(state->connectionId);
+    }
+}
+
+QueryServer::QueryServer(string address, CommandHandler handler) : address(std::move(address)),
+                                                                   handler(std::move(handler)),
+                                                                   wakeup(make_shared<Wakeup>()) {
+    listenOnAddress();
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeup->eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || wakeup->eventFd < 0) {
+        throw FileErrorException(" ERROR starting the server.");
+    }
+
+    epoll_event listenEvent{};
+    listenEvent.events = EPOLLIN;
+    listenEvent.data.u64 = LISTEN_ID;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &listenEvent);
+
+    epoll_event wakeupEvent{};
+    wakeupEvent.events = EPOLLIN;
+    wakeupEvent.data.u64 = WAKEUP_ID;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeup->eventFd, &wakeupEvent);
+}
+
+QueryServer::~QueryServer() {
+    for (auto& [connectionId, connection] : connections) {
+        close(connection.fd);
+    }
+    signalWakeupFd = -1;
+    if (listenFd >= 0) {
+        close(listenFd);
+    }
+    if (!socketPath.empty()) {
+        unlink(socketPath.c_str());
+    }
+    if (epollFd >= 0) {
+        close(epollFd);
+    }
+}
+
+void QueryServer::listenOnAddress() {
+    if (isNumber(address)) {
+        // loopback TCP port, the number must fit in 16 bits
+        if (address.size() > 5 || stoul(address) > MAX_PORT_NUMBER) {
+            throw FileErrorException(" ERROR listening on port " + address + ": port number out of range");
+        }
+        listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int reuse = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in socketAddress{};
+        socketAddress.sin_family = AF_INET;
+        socketAddress.sin_port = htons(static_cast<uint16_t>(stoi(address)));
+        socketAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&socketAddress), sizeof(socketAddress)) < 0) {
+            throw FileErrorException(" ERROR listening on port " + address + ": " + strerror(errno));
+        }
+    } else {
+        // Unix domain socket, a socket file left by a previous run is replaced, any other file is kept
+        sockaddr_un socketAddress{};
+        if (address.size() >= sizeof(socketAddress.sun_path)) {
+            throw FileErrorException(" ERROR listening on socket " + address + ": path too long");
+        }
+        listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        socketAddress.sun_family = AF_UNIX;
+        memcpy(socketAddress.sun_path, address.c_str(), address.size() + 1);
+        struct stat existing{};
+        if (lstat(address.c_str(), &existing) == 0 && S_ISSOCK(existing.st_mode)) {
+            unlink(address.c_str());
+        }
+        if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&socketAddress), sizeof(socketAddress)) < 0) {
+            throw FileErrorException(" ERROR listening on socket " + address + ": " + strerror(errno));
+        }
+        socketPath = address;
+    }
+
+    if (listen(listenFd, SOMAXCONN) < 0) {
+        throw FileErrorException(" ERROR listening on " + address + ": " + strerror(errno));
+    }
+}
+
+void QueryServer::run() {
+    stopRequested = 0;
+    signalWakeupFd = wakeup->eventFd;
+    struct sigaction stopAction{};
+    stopAction.sa_handler = requestStop;
+    sigemptyset(&stopAction.sa_mask);
+    struct sigaction previousInterrupt{};
+    struct sigaction previousTerminate{};
+    sigaction(SIGINT, &stopAction, &previousInterrupt);
+    sigaction(SIGTERM, &stopAction, &previousTerminate);
+
+    epoll_event events[64];
+    while (!stopRequested) {
+        int eventsCount = epoll_wait(epollFd, events, 64, -1);
+        if (eventsCount < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        for (int i = 0; i < eventsCount; i++) {
+            uint64_t id = events[i].data.u64;
+            if (id == LISTEN_ID) {
+                acceptClients();
+            } else if (id == WAKEUP_ID) {
+                uint64_t count;
+                ssize_t ignored = read(wakeup->eventFd, &count, sizeof(count));
+                (void) ignored;
+                resumeReadyConnections();
+            } else {
+                auto found = connections.find(id);
+                if (found == connections.end()) {
+                    // closed by an earlier event of this round
+                    continue;
+                }
+                if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                    // the client is gone in both directions, its responses can't be sent
+                    closeConnection(id);
+                    continue;
+                }
+                if (events[i].events & EPOLLIN) {
+                    readFromClient(id);
+                }
+                found = connections.find(id);
+                if (found != connections.end() && (events[i].events & EPOLLOUT)) {
+                    // room for more output, which may resume the paused commands
+                    serveConnection(id, found->second);
+                }
+            }
+        }
+    }
+
+    sigaction(SIGINT, &previousInterrupt, nullptr);
+    sigaction(SIGTERM, &previousTerminate, nullptr);
+    signalWakeupFd = -1;
+}
+
+void QueryServer::acceptClients() {
+    while (true) {
+        int clientFd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (clientFd < 0) {
+            // no more waiting clients, or a client that gave up meanwhile
+            return;
+        }
+
+        uint64_t connectionId = nextConnectionId++;
+        Connection& connection = connections[connectionId];
+        connection.fd = clientFd;
+        connection.events = EPOLLIN;
+        epoll_event clientEvent{};
+        clientEvent.events = connection.events;
+        clientEvent.data.u64 = connectionId;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, clientFd, &clientEvent);
+    }
+}
+
+void QueryServer::readFromClient(uint64_t connectionId) {
+    Connection& connection = connections[connectionId];
+    char buffer[1 << 16];
+    while (true) {
+        ssize_t bytesRead = recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (bytesRead > 0) {
+            connection.input.append(buffer, static_cast<size_t>(bytesRead));
+            continue;
+        }
+        if (bytesRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (bytesRead < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytesRead < 0) {
+            closeConnection(connectionId);
+            return;
+        }
+        // the client sent all its commands, the last line may miss its line break
+        connection.inputClosed = true;
+        if (!connection.input.empty() && connection.input.back() != '\n') {
+            connection.input += '\n';
+        }
+        break;
+    }
+
+    if (connection.input.find('\n') == string::npos && connection.input.size() > MAX_LINE_LENGTH) {
+        closeConnection(connectionId);
+        return;
+    }
+    serveConnection(connectionId, connection);
+}
+
+void QueryServer::executeCommands(uint64_t connectionId, Connection &connection) {
+    size_t lineStart = 0;
+    while (!connection.closing && connection.output.size() < MAX_PENDING_OUTPUT) {
+        // the next commands wait for the pending response
+        if (connection.pendingReply) {
+            lock_guard<mutex> lock(connection.pendingReply->replyMutex);
+            if (!connection.pendingReply->done) {
+                break;
+            }
+            connection.output += connection.pendingReply->text;
+            connection.output += '\n';
+            connection.pendingReply->waited = false;
+        }
+        connection.pendingReply.reset();
+
+        size_t lineEnd = connection.input.find('\n', lineStart);
+        if (lineEnd == string::npos) {
+            break;
+        }
+        string command = connection.input.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+        if (!command.empty() && command.back() == '\r') {
+            command.pop_back();
+        }
+
+        if (command == Commands::EXIT_COMMAND) {
+            connection.closing = true;
+            break;
+        }
+
+        auto replyState = make_shared<ReplyState>(connectionId, wakeup);
+        handler(command, Reply(replyState));
+        {
+            lock_guard<mutex> lock(replyState->replyMutex);
+            if (!replyState->done) {
+                // completed later by another thread, which wakes up the server
+                replyState->waited = true;
+                connection.pendingReply = replyState;
+                continue;
+            }
+            connection.output += replyState->text;
+            connection.output += '\n';
+        }
+    }
+    connection.input.erase(0, lineStart);
+
+    // nothing more will come from a client that closed its side
+    if (connection.inputClosed && !connection.pendingReply && connection.input.empty()) {
+        connection.closing = true;
+    }
+}
+
+void QueryServer::serveConnection(uint64_t connectionId, Connection &connection) {
+    while (true) {
+        executeCommands(connectionId, connection);
+        if (!flushConnection(connectionId, connection)) {
+            return;
+        }
+        // continue while all the output was sent and there are more commands to execute
+        bool hasCommands = !connection.closing && !connection.pendingReply && connection.input.find('\n') != string::npos;
+        if (!connection.output.empty() || !hasCommands) {
+            break;
+        }
+    }
+
+    // read more commands only when they can be executed, and wait for room when output is left
+    bool wantsInput = !connection.closing && !connection.inputClosed && !connection.pendingReply
+                      && connection.output.size() < MAX_PENDING_OUTPUT;
+    uint32_t events = (wantsInput ? EPOLLIN : 0u) | (connection.output.empty() ? 0u : EPOLLOUT);
+    if (events != connection.events) {
+        epoll_event clientEvent{};
+        clientEvent.events = events;
+        clientEvent.data.u64 = connectionId;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &clientEvent);
+        connection.events = events;
+    }
+}
+
+bool QueryServer::flushConnection(uint64_t connectionId, Connection &connection) {
+    size_t sentBytes = 0;
+    while (sentBytes < connection.output.size()) {
+        ssize_t sent = send(connection.fd, connection.output.data() + sentBytes, connection.output.size() - sentBytes,
+                            MSG_NOSIGNAL);
+        if (sent > 0) {
+            sentBytes += static_cast<size_t>(sent);
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            // the client went away
+            closeConnection(connectionId);
+            return false;
+        }
+    }
+    connection.output.erase(0, sentBytes);
+
+    if (connection.closing && connection.output.empty()) {
+        closeConnection(connectionId);
+        return false;
+    }
+    return true;
+}
+
+void QueryServer::resumeReadyConnections() {
+    vector<uint64_t> readyConnections;
+    {
+        lock_guard<mutex> lock(wakeup->readyMutex);
+        readyConnections.swap(wakeup->readyConnections);
+    }
+
+    for (uint64_t connectionId : readyConnections) {
+        auto found = connections.find(connectionId);
+        if (found == connections.end()) {
+            // the client left before its response was ready
+            continue;
+        }
+        serveConnection(connectionId, found->second);
+    }
+}
+
+void QueryServer::closeConnection(uint64_t connectionId) {
+    auto found = connections.find(connectionId);
+    if (found == connections.end()) {
+        return;
+    }
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, found->second.fd, nullptr);
+    close(found->second.fd);
+    connections.erase(found);
+}
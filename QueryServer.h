@@ -0,0 +1,182 @@
+#ifndef HW2_QUERYSERVER_H
+#define HW2_QUERYSERVER_H
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+using namespace std;
+
+/**
+ * A class that serves commands to many clients over a Unix domain socket or a loopback TCP port.
+ * A single thread waits for all the connections with epoll. Every connection has its own input and output buffers,
+ * and a client may send several commands without waiting for their responses: the commands of a connection are
+ * executed one at a time in their order, and their responses are sent in the same order.
+ * Every command is a line, and every response ends with an empty line. The "exit" command closes the connection.
+ */
+class QueryServer {
+private:
+    /**
+     * Connections that their pending response was completed by another thread, and a way to wake up the server.
+     * Shared with the responses, so a response that is completed after the server stopped doesn't touch a closed eventfd.
+     */
+    struct Wakeup {
+        int eventFd = -1;
+        mutex readyMutex;
+        vector<uint64_t> readyConnections;
+
+        ~Wakeup();
+
+        /**
+         * Mark a connection as ready and wake up the server.
+         * @param connectionId - id of the ready connection.
+         */
+        void notify(uint64_t connectionId);
+    };
+
+    /**
+     * The response of a single command, that may be completed after the command's handler returned.
+     */
+    struct ReplyState {
+        mutex replyMutex;
+        bool done = false;
+        // true once the server stopped waiting for the response and expects a wakeup
+        bool waited = false;
+        string text;
+        uint64_t connectionId;
+        shared_ptr<Wakeup> wakeup;
+
+        ReplyState(uint64_t connectionId, shared_ptr<Wakeup> wakeup) : connectionId(connectionId), wakeup(std::move(wakeup)) {}
+    };
+
+    /**
+     * A connected client.
+     */
+    struct Connection {
+        int fd;
+        // received bytes that were not executed yet
+        string input;
+        // response bytes that were not sent yet
+        string output;
+        // response of the command that the next commands wait for, null if none
+        shared_ptr<ReplyState> pendingReply;
+        // the client won't send more commands
+        bool inputClosed = false;
+        // the connection is closed once its output is sent
+        bool closing = false;
+        // the epoll events the connection is registered for
+        uint32_t events = 0;
+    };
+
+    // a connection with a longer line is closed
+    static constexpr size_t MAX_LINE_LENGTH = 1 << 16;
+    // the commands of a connection are paused while more output is waiting for the client
+    static constexpr size_t MAX_PENDING_OUTPUT = 1 << 20;
+
+public:
+    /**
+     * Completes the response of a command. May be used from any thread, once.
+     */
+    class Reply {
+    private:
+        shared_ptr<ReplyState> state;
+    public:
+        explicit Reply(shared_ptr<ReplyState> state) : state(std::move(state)) {}
+
+        /**
+         * Complete the response.
+         * @param text - the response's text, its trailing line breaks are replaced with a single one.
+         */
+        void send(string text) const;
+    };
+
+    /**
+     * Executes a command line (without its line break), and completes its reply now or later.
+     */
+    using CommandHandler = function<void(const string& command, Reply reply)>;
+
+private:
+    string address;
+    // path of the Unix domain socket, empty for a TCP port
+    string socketPath;
+    CommandHandler handler;
+    int listenFd = -1;
+    int epollFd = -1;
+    shared_ptr<Wakeup> wakeup;
+    unordered_map<uint64_t, Connection> connections;
+    uint64_t nextConnectionId = 1;
+
+    /**
+     * Create the listening socket of the address.
+     * @throws FileErrorException - if the address can't be listened on.
+     */
+    void listenOnAddress();
+
+    /**
+     * Accept all the waiting clients.
+     */
+    void acceptClients();
+
+    /**
+     * Read what a client sent, and execute its commands.
+     * @param connectionId - id of the client's connection.
+     */
+    void readFromClient(uint64_t connectionId);
+
+    /**
+     * Execute the complete commands of a connection in their order, until one of them has to be waited for.
+     * @param connectionId - id of the connection.
+     * @param connection - the connection.
+     */
+    void executeCommands(uint64_t connectionId, Connection& connection);
+
+    /**
+     * Send as much of a connection's output as the socket accepts, and close the connection if it's done.
+     * @param connectionId - id of the connection.
+     * @param connection - the connection.
+     * @return True if the connection is still open, otherwise false.
+     */
+    bool flushConnection(uint64_t connectionId, Connection& connection);
+
+    /**
+     * Execute a connection's commands and send their responses as long as the client takes them,
+     * then wait for the events that let the connection continue.
+     * @param connectionId - id of the connection.
+     * @param connection - the connection.
+     */
+    void serveConnection(uint64_t connectionId, Connection& connection);
+
+    /**
+     * Continue the connections that their pending response was completed.
+     */
+    void resumeReadyConnections();
+
+    /**
+     * Close a connection and forget it.
+     * @param connectionId - id of the connection.
+     */
+    void closeConnection(uint64_t connectionId);
+public:
+    /**
+     * Start listening for clients.
+     * @param address - a port number to listen on the loopback interface, or a path of a Unix domain socket.
+     * @param handler - executes the clients commands, called on the server's thread.
+     * @throws FileErrorException - if the address can't be listened on.
+     */
+    QueryServer(string address, CommandHandler handler);
+    ~QueryServer();
+
+    QueryServer(const QueryServer&) = delete;
+    QueryServer& operator=(const QueryServer&) = delete;
+
+    /**
+     * Serve the clients until the process is interrupted (SIGINT) or terminated (SIGTERM).
+     */
+    void run();
+};
+
+
+#endif //HW2_QUERYSERVER_H
@@ -0,0 +1,60 @@
+#ifndef HW2_RADIXSORT_H
+#define HW2_RADIXSORT_H
+#include <iostream>
+#include <vector>
+#include <array>
+#include <numeric>
+#include <cstdint>
+using namespace std;
+
+/**
+ * A class that sorts records by keys made of 32 bits words, with a stable LSD radix sort of a byte per pass.
+ * The records are not moved, their indexes are sorted. A pass where all the keys have the same byte is skipped,
+ * so small port ids and minutes cost only the passes of their significant bytes.
+ */
+class RadixSort {
+private:
+    static constexpr size_t RADIX = 256;
+public:
+    /**
+     * Sort the indexes of records by their keys.
+     * @param count - amount of records, up to 2^32.
+     * @param keyWords - amount of 32 bits words in every key.
+     * @param keyWord - callable (record index, word index) -> uint32_t, word 0 is the most significant.
+     * @return Indexes of the records ordered by their keys, records with equal keys in their original order.
+     */
+    template<typename KeyWord>
+    static vector<uint32_t> sortIndexes(size_t count, size_t keyWords, KeyWord keyWord) {
+        vector<uint32_t> order(count);
+        iota(order.begin(), order.end(), 0);
+        vector<uint32_t> buffer(count);
+
+        for (size_t word = keyWords; word-- > 0;) {
+            for (unsigned shift = 0; shift < 32; shift += 8) {
+                array<size_t, RADIX> positions{};
+                for (uint32_t record : order) {
+                    positions[(keyWord(record, word) >> shift) & (RADIX - 1)]++;
+                }
+                // all the keys have the same byte, the order doesn't change
+                bool singleBucket = false;
+                for (size_t bucketCount : positions) {
+                    singleBucket |= bucketCount == count;
+                }
+                if (singleBucket) {
+                    continue;
+                }
+
+                // counts to the first position of every byte
+                exclusive_scan(positions.begin(), positions.end(), positions.begin(), size_t(0));
+                for (uint32_t record : order) {
+                    buffer[positions[(keyWord(record, word) >> shift) & (RADIX - 1)]++] = record;
+                }
+                order.swap(buffer);
+            }
+        }
+        return order;
+    }
+};
+
+
+#endif //HW2_RADIXSORT_H
@@ -0,0 +1,77 @@
+#include "RouteFinder.h"
+#include "TimesGraph.h"
+#include <algorithm>
+
+void RouteFinder::startSearch(size_t portsCount) {
+    if (portsCount > distances.size()) {
+        distances.resize(portsCount);
+        previousSails.resize(portsCount);
+        stamps.resize(portsCount, 0);
+        settledStamps.resize(portsCount, 0);
+    }
+
+    currentStamp++;
+    if (currentStamp == 0) {
+        // the stamp wrapped around, old stamps may look current
+        fill(stamps.begin(), stamps.end(), 0);
+        fill(settledStamps.begin(), settledStamps.end(), 0);
+        currentStamp = 1;
+    }
+    heap.clear();
+}
+
+optional<vector<size_t>> RouteFinder::findFastestRoute(const TimesGraph &timesGraph, PortId srcPort, PortId destPort) {
+    const auto& sails = timesGraph.getSails();
+    startSearch(timesGraph.getPortsCount());
+
+    auto greater = [](const pair<long long, PortId>& first, const pair<long long, PortId>& second) {
+        return first.first > second.first;
+    };
+
+    distances[srcPort] = 0;
+    stamps[srcPort] = currentStamp;
+    heap.emplace_back(0, srcPort);
+
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), greater);
+        auto [distance, port] = heap.back();
+        heap.pop_back();
+
+        if (settledStamps[port] == currentStamp) {
+            // stale heap entry
+            continue;
+        }
+        settledStamps[port] = currentStamp;
+
+        if (port == destPort) {
+            break;
+        }
+
+        for (size_t sailIndex : timesGraph.getOutgoingSails(port)) {
+            PortId nextPort = sails.getDestPort(sailIndex);
+            // Dijkstra needs non-negative weights, an edge can't make the route shorter
+            long long sailTime = max(0, sails.getAverageSailTime(sailIndex));
+            long long nextDistance = distance + sailTime;
+
+            if (stamps[nextPort] != currentStamp || nextDistance < distances[nextPort]) {
+                distances[nextPort] = nextDistance;
+                previousSails[nextPort] = sailIndex;
+                stamps[nextPort] = currentStamp;
+                heap.emplace_back(nextDistance, nextPort);
+                push_heap(heap.begin(), heap.end(), greater);
+            }
+        }
+    }
+
+    if (settledStamps[destPort] != currentStamp) {
+        return nullopt;
+    }
+
+    // walk back from the destination to the source
+    vector<size_t> route;
+    for (PortId port = destPort; port != srcPort; port = sails.getSrcPort(previousSails[port])) {
+        route.push_back(previousSails[port]);
+    }
+    reverse(route.begin(), route.end());
+    return route;
+}
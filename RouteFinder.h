@@ -0,0 +1,48 @@
+#ifndef HW2_ROUTEFINDER_H
+#define HW2_ROUTEFINDER_H
+#include <iostream>
+#include <vector>
+#include <optional>
+#include <cstdint>
+#include "Port.h"
+using namespace std;
+
+class TimesGraph;
+
+/**
+ * A class that finds the fastest multi-leg route between two ports of the times graph (Dijkstra's algorithm),
+ * using the average sail time of every edge.
+ * The search arrays are kept between searches and reset by a generation stamp, so repeated searches don't allocate.
+ * A route finder isn't thread safe, every thread should use its own.
+ */
+class RouteFinder {
+private:
+    // best known distance of every port, valid only if the port's stamp is the current search's stamp
+    vector<long long> distances;
+    // the sail index used to reach every port
+    vector<size_t> previousSails;
+    vector<uint32_t> stamps;
+    // ports that their distance is final
+    vector<uint32_t> settledStamps;
+    uint32_t currentStamp = 0;
+    // (distance, port) min heap with lazy deletion
+    vector<pair<long long, PortId>> heap;
+
+    /**
+     * Prepare the search arrays for a new search.
+     * @param portsCount - amount of ports in the graph.
+     */
+    void startSearch(size_t portsCount);
+public:
+    /**
+     * Find the fastest route between two ports.
+     * @param timesGraph - the times graph to search.
+     * @param srcPort - id of the route's source port.
+     * @param destPort - id of the route's destination port.
+     * @return Indexes of the route's sails in the graph, in sailing order, or nullopt if there is no route.
+     */
+    optional<vector<size_t>> findFastestRoute(const TimesGraph& timesGraph, PortId srcPort, PortId destPort);
+};
+
+
+#endif //HW2_ROUTEFINDER_H
@@ -0,0 +1,37 @@
+#ifndef HW2_SAILKEY_H
+#define HW2_SAILKEY_H
+#include <iostream>
+#include <functional>
+#include <compare>
+#include "Port.h"
+
+/**
+ * A struct that identifies a containers sail by its ports and times.
+ * Two sails with the same key are the same sail.
+ */
+struct SailKey {
+    PortId srcPort;
+    PortId destPort;
+    int startMinute;
+    int endMinute;
+
+    bool operator==(const SailKey& other) const = default;
+    auto operator<=>(const SailKey& other) const = default;
+};
+
+/**
+ * Hash function of a sail key, so sails can be kept in hash based containers.
+ */
+struct SailKeyHash {
+    size_t operator()(const SailKey& key) const {
+        uint64_t ports = (static_cast<uint64_t>(key.srcPort) << 32) | key.destPort;
+        uint64_t times = (static_cast<uint64_t>(static_cast<uint32_t>(key.startMinute)) << 32)
+                         | static_cast<uint32_t>(key.endMinute);
+        // mix both words so close keys don't collide
+        uint64_t hash = ports * 0x9E3779B97F4A7C15ULL;
+        hash ^= times + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+        return std::hash<uint64_t>{}(hash);
+    }
+};
+
+#endif //HW2_SAILKEY_H
@@ -0,0 +1,79 @@
+#include "SailTimeStats.h"
+#include <bit>
+#include <cmath>
+#include <algorithm>
+
+size_t SailTimeStats::bucketOf(int sailTime) {
+    if (sailTime < 4) {
+        return static_cast<size_t>(max(sailTime, 0));
+    }
+    // the power of two is the position of the highest set bit, the next two bits choose the quarter
+    auto time = static_cast<uint32_t>(sailTime);
+    size_t exponent = static_cast<size_t>(bit_width(time)) - 1;
+    size_t quarter = (time >> (exponent - 2)) & 3;
+    return min(4 * (exponent - 1) + quarter, BUCKETS_COUNT - 1);
+}
+
+int64_t SailTimeStats::bucketLowerBound(size_t bucket) {
+    if (bucket < 4) {
+        return static_cast<int64_t>(bucket);
+    }
+    size_t exponent = bucket / 4 + 1;
+    size_t quarter = bucket % 4;
+    return static_cast<int64_t>(4 + quarter) << (exponent - 2);
+}
+
+void SailTimeStats::add(int sailTime) {
+    if (count == 0) {
+        minSailTime = sailTime;
+        maxSailTime = sailTime;
+    } else {
+        minSailTime = min(minSailTime, sailTime);
+        maxSailTime = max(maxSailTime, sailTime);
+    }
+    count++;
+
+    double delta = sailTime - mean;
+    mean += delta / count;
+    m2 += delta * (sailTime - mean);
+
+    buckets[bucketOf(sailTime)]++;
+}
+
+double SailTimeStats::getStandardDeviation() const {
+    return sqrt(getVariance());
+}
+
+int SailTimeStats::percentile(double percentile) const {
+    if (count == 0) {
+        return 0;
+    }
+
+    // rank of the percentile's sail time, 1 based
+    auto rank = static_cast<uint64_t>(ceil(percentile / 100 * count));
+    rank = clamp<uint64_t>(rank, 1, count);
+
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < BUCKETS_COUNT; bucket++) {
+        seen += buckets[bucket];
+        if (seen >= rank) {
+            int64_t middle = (bucketLowerBound(bucket) + bucketLowerBound(bucket + 1) - 1) / 2;
+            return static_cast<int>(clamp<int64_t>(middle, minSailTime, maxSailTime));
+        }
+    }
+    return maxSailTime;
+}
+
+void SailTimeStats::print(OutputWriter &out) const {
+    out << "(n=" << count << ", mean " << llround(getMean())
+        << ", sd " << llround(getStandardDeviation()) << ", p50 " << percentile(50)
+        << ", p95 " << percentile(95) << ")";
+}
+
+bool SailTimeStats::isValid() const {
+    uint64_t total = 0;
+    for (uint32_t bucketCount : buckets) {
+        total += bucketCount;
+    }
+    return total == count && minSailTime <= maxSailTime && isfinite(mean) && isfinite(m2) && m2 >= 0;
+}
@@ -0,0 +1,91 @@
+#ifndef HW2_SAILTIMESTATS_H
+#define HW2_SAILTIMESTATS_H
+#include <iostream>
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include "OutputWriter.h"
+using namespace std;
+
+/**
+ * A class that summarizes the sail times of a times graph's edge in a fixed size, however many sails it has.
+ * The count, mean and variance are exact (Welford's online algorithm), and the percentiles are estimated
+ * from a histogram with four buckets per power of two minutes, so an estimate is within 12.5% of the real time.
+ * Trivially copyable, so it's saved in snapshots as is.
+ */
+class SailTimeStats {
+public:
+    // bucket i < 4 counts the sail times of exactly i minutes (shorter times are counted in bucket 0),
+    // then every power of two is split into four buckets, the last one counts all the longer times
+    static constexpr size_t BUCKETS_COUNT = 80;
+private:
+    uint32_t count = 0;
+    int32_t minSailTime = 0;
+    int32_t maxSailTime = 0;
+    double mean = 0;
+    // sum of the squared differences from the mean
+    double m2 = 0;
+    array<uint32_t, BUCKETS_COUNT> buckets{};
+
+    /**
+     * @param sailTime - sail time in minutes.
+     * @return The bucket that counts the sail time.
+     */
+    static size_t bucketOf(int sailTime);
+
+    /**
+     * @param bucket - index of a bucket.
+     * @return The shortest sail time counted by the bucket.
+     */
+    static int64_t bucketLowerBound(size_t bucket);
+public:
+    /**
+     * Record the sail time of a single sail.
+     * @param sailTime - the sail time in minutes.
+     */
+    void add(int sailTime);
+
+    /**
+     * @return Amount of the recorded sails.
+     */
+    uint32_t getCount() const { return count; }
+
+    /**
+     * @return Mean of the recorded sail times in minutes, 0 if empty.
+     */
+    double getMean() const { return mean; }
+
+    /**
+     * @return Sample variance of the recorded sail times, 0 if less than two sails were recorded.
+     */
+    double getVariance() const { return count < 2 ? 0 : m2 / (count - 1); }
+
+    /**
+     * @return Sample standard deviation of the recorded sail times.
+     */
+    double getStandardDeviation() const;
+
+    /**
+     * Estimate a percentile of the recorded sail times.
+     * @param percentile - the percentile, between 0 and 100.
+     * @return The middle of the percentile's bucket in minutes (within the recorded range), 0 if empty.
+     */
+    int percentile(double percentile) const;
+
+    /**
+     * Print the summary as "(n=<count>, mean <m>, sd <s>, p50 <t>, p95 <t>)", in whole minutes.
+     * @param out - reference for the output writer
+     */
+    void print(OutputWriter& out) const;
+
+    /**
+     * Check that the summary is consistent, as it may be read from a damaged snapshot.
+     * @return True if the buckets add up to the count and the range is ordered, otherwise false.
+     */
+    bool isValid() const;
+};
+
+static_assert(std::is_trivially_copyable_v<SailTimeStats>, "SailTimeStats should be trivially copyable");
+
+
+#endif //HW2_SAILTIMESTATS_H
@@ -0,0 +1,209 @@
+#include "Snapshot.h"
+#include "MappedFile.h"
+#include "FileErrorException.h"
+#include "InvalidInputException.h"
+#include <fstream>
+#include <cstring>
+
+void Snapshot::save(const std::string &snapshotFilename, const ContainersGraph &containersGraph, const TimesGraph &timesGraph) {
+    const auto& portRegistry = *timesGraph.getPortRegistry();
+    const auto& containersSails = containersGraph.getSails();
+    const auto& timesSails = timesGraph.getSails();
+    const auto& foldedKeys = containersGraph.getFoldedKeys();
+    const auto& timetable = timesGraph.getTimetable();
+    size_t connectionsCount = timetable.getConnections().size() + timetable.getPendingConnections().size();
+
+    // ports table and names blob
+    vector<PortRecord> ports;
+    string names;
+    ports.reserve(portRegistry.size());
+    for (PortId port = 0; port < portRegistry.size(); port++) {
+        string_view name = portRegistry.getName(port);
+        uint32_t flags = (containersGraph.hasPort(port) ? IN_CONTAINERS_GRAPH : 0) | (timesGraph.hasPort(port) ? IN_TIMES_GRAPH : 0);
+        auto [baselineBalance, baselineInbound] = containersGraph.getBaseline(port);
+        ports.push_back({names.size(), static_cast<uint32_t>(name.size()), flags, baselineBalance, baselineInbound});
+        names += name;
+    }
+
+    Header header{};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.portsCount = static_cast<uint32_t>(ports.size());
+    header.namesSize = names.size();
+    header.containersSailsCount = containersSails.size();
+    header.timesSailsCount = timesSails.size();
+    header.portsOffset = align(sizeof(Header));
+    header.namesOffset = align(header.portsOffset + ports.size() * sizeof(PortRecord));
+    header.foldedSailsCount = foldedKeys.size();
+    header.foldedSailsOffset = align(header.namesOffset + names.size());
+    header.containersSailsOffset = align(header.foldedSailsOffset + foldedKeys.size() * sizeof(FoldedSailRecord));
+    header.timesSailsOffset = align(header.containersSailsOffset + containersSails.size() * sizeof(ContainersSailRecord));
+    header.connectionsCount = connectionsCount;
+    header.connectionsOffset = align(header.timesSailsOffset + timesSails.size() * sizeof(TimesSailRecord));
+    header.horizonMinute = containersGraph.getHorizon().toMinutes();
+
+    ofstream snapshotFile(snapshotFilename, ios::binary | ios::trunc);
+    if (!snapshotFile) {
+        throw FileErrorException(" ERROR opening/writing the snapshot file.");
+    }
+
+    // pad the file up to the given section offset
+    auto seekTo = [&snapshotFile](uint64_t offset) {
+        static const char padding[8] = {};
+        auto position = static_cast<uint64_t>(snapshotFile.tellp());
+        snapshotFile.write(padding, static_cast<streamsize>(offset - position));
+    };
+
+    snapshotFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    seekTo(header.portsOffset);
+    snapshotFile.write(reinterpret_cast<const char*>(ports.data()), static_cast<streamsize>(ports.size() * sizeof(PortRecord)));
+    seekTo(header.namesOffset);
+    snapshotFile.write(names.data(), static_cast<streamsize>(names.size()));
+
+    seekTo(header.foldedSailsOffset);
+    for (const auto& key : foldedKeys) {
+        FoldedSailRecord record{key.srcPort, key.destPort, key.startMinute, key.endMinute};
+        snapshotFile.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+
+    seekTo(header.containersSailsOffset);
+    for (size_t sail = 0; sail < containersSails.size(); sail++) {
+        ContainersSailRecord record{containersSails.getSrcPort(sail), containersSails.getDestPort(sail),
+                                    containersSails.getStartDate(sail).toMinutes(),
+                                    containersSails.getEndDate(sail).toMinutes(), containersSails.getContainers(sail)};
+        snapshotFile.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+
+    seekTo(header.timesSailsOffset);
+    for (size_t sail = 0; sail < timesSails.size(); sail++) {
+        TimesSailRecord record{timesSails.getSrcPort(sail), timesSails.getDestPort(sail),
+                               timesSails.getStartDate(sail).toMinutes(),
+                               timesSails.getEndDate(sail).toMinutes(), timesSails.getAverageSailTime(sail),
+                               timesSails.getStats(sail)};
+        snapshotFile.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+
+    seekTo(header.connectionsOffset);
+    for (const auto* connections : {&timetable.getConnections(), &timetable.getPendingConnections()}) {
+        for (const auto& connection : *connections) {
+            ConnectionRecord record{connection.srcPort, connection.destPort, connection.departureMinute,
+                                    connection.arrivalMinute};
+            snapshotFile.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        }
+    }
+
+    if (!snapshotFile.flush()) {
+        throw FileErrorException(" ERROR opening/writing the snapshot file.");
+    }
+}
+
+void Snapshot::restore(const std::string &snapshotFilename, ContainersGraph &containersGraph, TimesGraph &timesGraph) {
+    MappedFile snapshotFile(snapshotFilename);
+    string_view contents = snapshotFile.getContents();
+    InvalidInputException invalidSnapshot("Invalid snapshot file " + snapshotFilename + "\n");
+
+    // validate the header and the sections bounds
+    Header header{};
+    if (contents.size() < sizeof(Header)) {
+        throw invalidSnapshot;
+    }
+    memcpy(&header, contents.data(), sizeof(Header));
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+        throw invalidSnapshot;
+    }
+
+    auto sectionFits = [&contents](uint64_t offset, uint64_t count, uint64_t recordSize) {
+        return offset % 8 == 0 && offset <= contents.size() && count <= (contents.size() - offset) / recordSize;
+    };
+    if (!sectionFits(header.portsOffset, header.portsCount, sizeof(PortRecord))
+        || !sectionFits(header.namesOffset, header.namesSize, 1)
+        || !sectionFits(header.foldedSailsOffset, header.foldedSailsCount, sizeof(FoldedSailRecord))
+        || !sectionFits(header.containersSailsOffset, header.containersSailsCount, sizeof(ContainersSailRecord))
+        || !sectionFits(header.timesSailsOffset, header.timesSailsCount, sizeof(TimesSailRecord))
+        || !sectionFits(header.connectionsOffset, header.connectionsCount, sizeof(ConnectionRecord))) {
+        throw invalidSnapshot;
+    }
+
+    // the sections are aligned, so the records are read in place
+    auto ports = reinterpret_cast<const PortRecord*>(contents.data() + header.portsOffset);
+    string_view names = contents.substr(header.namesOffset, header.namesSize);
+    auto foldedSails = reinterpret_cast<const FoldedSailRecord*>(contents.data() + header.foldedSailsOffset);
+    auto containersSails = reinterpret_cast<const ContainersSailRecord*>(contents.data() + header.containersSailsOffset);
+    auto timesSails = reinterpret_cast<const TimesSailRecord*>(contents.data() + header.timesSailsOffset);
+    auto connections = reinterpret_cast<const ConnectionRecord*>(contents.data() + header.connectionsOffset);
+
+    // validate all the records before changing anything, so a damaged snapshot leaves the graphs as they were
+    for (uint32_t i = 0; i < header.portsCount; i++) {
+        if (ports[i].nameOffset > names.size() || ports[i].nameLength > names.size() - ports[i].nameOffset) {
+            throw invalidSnapshot;
+        }
+    }
+    auto validPorts = [&header](uint32_t srcPort, uint32_t destPort) {
+        return srcPort < header.portsCount && destPort < header.portsCount;
+    };
+    for (uint64_t i = 0; i < header.foldedSailsCount; i++) {
+        if (!validPorts(foldedSails[i].srcPort, foldedSails[i].destPort)) {
+            throw invalidSnapshot;
+        }
+    }
+    for (uint64_t i = 0; i < header.containersSailsCount; i++) {
+        if (!validPorts(containersSails[i].srcPort, containersSails[i].destPort)) {
+            throw invalidSnapshot;
+        }
+    }
+    for (uint64_t i = 0; i < header.timesSailsCount; i++) {
+        if (!validPorts(timesSails[i].srcPort, timesSails[i].destPort) || !timesSails[i].stats.isValid()) {
+            throw invalidSnapshot;
+        }
+    }
+    for (uint64_t i = 0; i < header.connectionsCount; i++) {
+        if (!validPorts(connections[i].srcPort, connections[i].destPort)) {
+            throw invalidSnapshot;
+        }
+    }
+
+    // saved port ids may differ from the registry's ids if the registry isn't empty
+    auto& portRegistry = *timesGraph.getPortRegistry();
+    vector<PortId> portsIds(header.portsCount);
+    for (uint32_t i = 0; i < header.portsCount; i++) {
+        PortId port = portRegistry.intern(names.substr(ports[i].nameOffset, ports[i].nameLength));
+        portsIds[i] = port;
+        if (ports[i].flags & IN_CONTAINERS_GRAPH) {
+            containersGraph.addPort(port);
+        }
+        if (ports[i].flags & IN_TIMES_GRAPH) {
+            timesGraph.addPort(port);
+        }
+        if (ports[i].baselineBalance != 0 || ports[i].baselineInbound != 0) {
+            containersGraph.restoreBaseline(port, ports[i].baselineBalance, ports[i].baselineInbound);
+        }
+    }
+    containersGraph.restoreHorizon(Date::fromMinutes(header.horizonMinute));
+    timesGraph.compactTimetable(Date::fromMinutes(header.horizonMinute));
+
+    vector<SailKey> foldedKeys;
+    foldedKeys.reserve(header.foldedSailsCount);
+    for (uint64_t i = 0; i < header.foldedSailsCount; i++) {
+        const auto& record = foldedSails[i];
+        foldedKeys.push_back({portsIds[record.srcPort], portsIds[record.destPort], record.startMinute, record.endMinute});
+    }
+    containersGraph.restoreFoldedKeys(std::move(foldedKeys));
+
+    for (uint64_t i = 0; i < header.containersSailsCount; i++) {
+        const auto& record = containersSails[i];
+        containersGraph.addSail(portsIds[record.srcPort], portsIds[record.destPort], Date::fromMinutes(record.startMinute),
+                                Date::fromMinutes(record.endMinute), record.containers);
+    }
+
+    for (uint64_t i = 0; i < header.timesSailsCount; i++) {
+        const auto& record = timesSails[i];
+        timesGraph.restoreSail(portsIds[record.srcPort], portsIds[record.destPort], Date::fromMinutes(record.startMinute),
+                               Date::fromMinutes(record.endMinute), record.averageSailTime, record.stats);
+    }
+
+    for (uint64_t i = 0; i < header.connectionsCount; i++) {
+        const auto& record = connections[i];
+        timesGraph.restoreConnection(portsIds[record.srcPort], portsIds[record.destPort], record.departureMinute,
+                                     record.arrivalMinute);
+    }
+}
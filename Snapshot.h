@@ -0,0 +1,116 @@
+#ifndef HW2_SNAPSHOT_H
+#define HW2_SNAPSHOT_H
+#include <iostream>
+#include <memory>
+#include <cstdint>
+#include "ContainersGraph.h"
+#include "TimesGraph.h"
+using namespace std;
+
+/**
+ * A class that saves the transportation graphs into a binary snapshot file and restores them from it.
+ *
+ * The snapshot is a header followed by fixed size records, all in the machine's native byte order:
+ * the ports table (with the baselines of the compacted sails), the ports names blob, the keys of the compacted sails,
+ * the containers graph's edges, the times graph's edges (with their current average sail time and sail times
+ * summary) and the times graph's scheduled connections. Every section starts at an 8 bytes aligned offset, so the file can be mapped and read in place.
+ */
+class Snapshot {
+private:
+    static constexpr char MAGIC[8] = {'H', 'W', '2', 'S', 'N', 'A', 'P', '\0'};
+    static constexpr uint32_t VERSION = 5;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t portsCount;
+        uint64_t namesSize;
+        uint64_t containersSailsCount;
+        uint64_t timesSailsCount;
+        uint64_t portsOffset;
+        uint64_t namesOffset;
+        uint64_t containersSailsOffset;
+        uint64_t timesSailsOffset;
+        // compaction horizon of the containers graph
+        int32_t horizonMinute;
+        uint32_t padding;
+        uint64_t foldedSailsCount;
+        uint64_t foldedSailsOffset;
+        uint64_t connectionsCount;
+        uint64_t connectionsOffset;
+    };
+
+    struct PortRecord {
+        uint64_t nameOffset;
+        uint32_t nameLength;
+        // bit 0 - vertex of the containers graph, bit 1 - vertex of the times graph
+        uint32_t flags;
+        // the port's baseline of the compacted containers sails
+        int32_t baselineBalance;
+        int32_t baselineInbound;
+    };
+
+    struct ContainersSailRecord {
+        uint32_t srcPort;
+        uint32_t destPort;
+        int32_t startMinute;
+        int32_t endMinute;
+        int32_t containers;
+    };
+
+    // key of a containers sail that was folded into the baselines
+    struct FoldedSailRecord {
+        uint32_t srcPort;
+        uint32_t destPort;
+        int32_t startMinute;
+        int32_t endMinute;
+    };
+
+    // a sail of the times graph's timetable
+    struct ConnectionRecord {
+        uint32_t srcPort;
+        uint32_t destPort;
+        int32_t departureMinute;
+        int32_t arrivalMinute;
+    };
+
+    struct TimesSailRecord {
+        uint32_t srcPort;
+        uint32_t destPort;
+        int32_t startMinute;
+        int32_t endMinute;
+        int32_t averageSailTime;
+        SailTimeStats stats;
+    };
+
+    static constexpr uint32_t IN_CONTAINERS_GRAPH = 1;
+    static constexpr uint32_t IN_TIMES_GRAPH = 2;
+
+    /**
+     * Round an offset up to the next 8 bytes boundary.
+     */
+    static uint64_t align(uint64_t offset) { return (offset + 7) & ~static_cast<uint64_t>(7); }
+public:
+    /**
+     * Save the transportation graphs into a snapshot file.
+     * @param snapshotFilename - the name of the snapshot file.
+     * @param containersGraph - transportation containers graph.
+     * @param timesGraph - transportation times graph.
+     * @throws FileErrorException - if the file failed to open / write.
+     */
+    static void save(const string& snapshotFilename, const ContainersGraph& containersGraph, const TimesGraph& timesGraph);
+
+    /**
+     * Restore the transportation graphs from a snapshot file.
+     * The graphs should be empty and share an empty port registry, so the ports get their saved ids.
+     * @param snapshotFilename - the name of the snapshot file.
+     * @param containersGraph - transportation containers graph.
+     * @param timesGraph - transportation times graph.
+     * @throws FileErrorException - if the file not found or failed to open / read.
+     * @throws InvalidInputException - if the file is not a valid snapshot, the graphs and the registry are left unchanged.
+     */
+    static void restore(const string& snapshotFilename, ContainersGraph& containersGraph, TimesGraph& timesGraph);
+};
+
+
+#endif //HW2_SNAPSHOT_H
@@ -3,19 +3,25 @@
 #include "InvalidInputException.h"
 #include "DateFormatException.h"
 #include "PortNotExistsException.h"
+#include "CompactedDateException.h"
 #include "Commands.h"
+#include "CommandStats.h"
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <charconv>
+#include <algorithm>
 
-bool SystemUtils::isValidPortName(const std::string &portName) {
+mutex SystemUtils::outputFileMutex;
+
+bool SystemUtils::isValidPortName(std::string_view portName) {
     // length validation
     if (portName.size() > 16) {
         return false;
     }
 
     // alpha or space characters only validation
-    for (char ch : portName) {
+    for (unsigned char ch : portName) {
         if (!isalpha(ch) && !isspace(ch)) {
             return false;
         }
@@ -24,215 +30,510 @@ bool SystemUtils::isValidPortName(const std::string &portName) {
     return true;
 }
 
-vector<tuple<shared_ptr<Port>, shared_ptr<Date>, shared_ptr<Date>, int>>
-SystemUtils::parseInputFile(const string & inputFilename) {
-    vector<tuple<shared_ptr<Port>, shared_ptr<Date>, shared_ptr<Date>, int>> parsedContent;
-    string line;
+bool SystemUtils::parseContainers(std::string_view containersStr, int &containers) {
+    // skip leading whitespaces
+    size_t start = 0;
+    while (start < containersStr.size() && isspace(static_cast<unsigned char>(containersStr[start]))) {
+        start++;
+    }
+    if (start < containersStr.size() && containersStr[start] == '+') {
+        start++;
+    }
+
+    // and trailing ones
+    size_t end = containersStr.size();
+    while (end > start && isspace(static_cast<unsigned char>(containersStr[end - 1]))) {
+        end--;
+    }
+
+    const char* first = containersStr.data() + start;
+    const char* last = containersStr.data() + end;
+    auto [parsedEnd, error] = from_chars(first, last, containers);
+    if (error != errc() || parsedEnd != last) {
+        return false;
+    }
+
+    return containers >= 0;
+}
+
+bool SystemUtils::parseInputLine(std::string_view line, bool isOriginLine, tuple<string_view, Date, Date, int> &row) {
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+
+    // split the line into its comma separated tokens, a trailing comma doesn't start a new token
+    string_view tokens[4];
+    size_t tokensCount = 0;
+    size_t tokenStart = 0;
+    while (tokenStart < line.size()) {
+        size_t tokenEnd = line.find(',', tokenStart);
+        if (tokenEnd == string_view::npos) {
+            tokenEnd = line.size();
+        }
+        if (tokensCount == 4) {
+            // too many tokens for any line
+            return false;
+        }
+        tokens[tokensCount++] = line.substr(tokenStart, tokenEnd - tokenStart);
+        tokenStart = tokenEnd + 1;
+    }
+
+    if (isOriginLine) {
+        // first line of the file
+        if (tokensCount != 2) {
+            // invalid length for the first line
+            return false;
+        }
+        string_view portName = tokens[0];
+        Date startTime;
+        if (!isValidPortName(portName) || !Date::tryParse(tokens[1], startTime)) {
+            return false;
+        }
+        row = {portName, startTime, Date(), 0};
+    } else {
+        if (tokensCount != 4) {
+            // invalid length for any other line
+            return false;
+        }
+        string_view portName = tokens[0];
+        Date startTime;
+        Date endTime;
+        int containers;
+        if (!isValidPortName(portName) || !parseContainers(tokens[2], containers)
+            || !Date::tryParse(tokens[1], startTime) || !Date::tryParse(tokens[3], endTime)) {
+            return false;
+        }
+        row = {portName, startTime, endTime, containers};
+    }
+    return true;
+}
+
+vector<tuple<string_view, Date, Date, int>>
+SystemUtils::parseInputFile(const MappedFile& inputFile, const string & inputFilename) {
+    vector<tuple<string_view, Date, Date, int>> parsedContent;
+    string_view contents = inputFile.getContents();
     int lineNum = 0;
 
-    ifstream inputFile(inputFilename);
-    if (!inputFile) {
-        throw FileErrorException(" ERROR opening/reading the specified file.");
-    }
-
-    while (getline(inputFile, line)) {
-        if (!line.empty() && line.back() == '\r') {
-            line.pop_back();
-        }
-
-        istringstream ss(line);
-        string token;
-        vector<string> tokens;
-        string lineNumStr = to_string(lineNum + 1);
-
-        while (getline(ss, token, ',')) {
-            tokens.push_back(token);
-        }
-
-        if (lineNum == 0) {
-            // first line of the file
-            if (tokens.size() == 2) {
-                string portName = tokens[0];
-                string startTimeStr = tokens[1];
-                if (!isValidPortName(portName)) {
-                    throw InvalidInputException("Invalid input in file " + inputFilename + " at line " + lineNumStr + "\n");
-                }
-                try {
-                    shared_ptr<Date> startTime = make_shared<Date>(startTimeStr);
-                    shared_ptr<Port> port = make_shared<Port>(portName);
-                    parsedContent.emplace_back(port, startTime, nullptr, 0);
-                } catch (DateFormatException&) {
-                    throw InvalidInputException("Invalid input in file " + inputFilename + " at line " + lineNumStr + "\n");
-                }
-            } else {
-                // invalid length for the first line
-                throw InvalidInputException("Invalid input in file " + inputFilename + " at line " + lineNumStr + "\n");
-            }
-        } else {
-            if (tokens.size() == 4) {
-                string portName = tokens[0];
-                string startTimeStr = tokens[1];
-                string containersStr = tokens[2];
-                string endTimeStr = tokens[3];
-
-                if (!isValidPortName(portName)) {
-                    throw InvalidInputException("Invalid input in file " + inputFilename + " at line " + lineNumStr + "\n");
-                }
-
-                try {
-                    int containers = stoi(containersStr);
-
-                    if (containers < 0) {
-                        throw InvalidInputException("Invalid input in file " + inputFilename + " at line " + lineNumStr + "\n");
-                    }
-
-                    shared_ptr<Date> startTime = make_shared<Date>(startTimeStr);
-                    shared_ptr<Date> endTime = make_shared<Date>(endTimeStr);
-                    shared_ptr<Port> port = make_shared<Port>(portName);
-                    parsedContent.emplace_back(port, startTime, endTime, containers);
-                } catch (std::invalid_argument&) {
-                    throw InvalidInputException("Invalid input in file " + inputFilename + " at line " + lineNumStr + "\n");
-                } catch (DateFormatException&) {
-                    throw InvalidInputException("Invalid input in file " + inputFilename + " at line " + lineNumStr + "\n");
-                }
-
-            } else {
-                // invalid length for any other line
-                throw InvalidInputException("Invalid input in file " + inputFilename + " at line " + lineNumStr + "\n");
-            }
+    auto invalidInput = [&inputFilename](int lineNum) {
+        return InvalidInputException("Invalid input in file " + inputFilename + " at line " + to_string(lineNum + 1) + "\n");
+    };
+
+    // one row per line, so a single allocation is enough
+    parsedContent.reserve(count(contents.begin(), contents.end(), '\n') + 1);
+
+    size_t lineStart = 0;
+    while (lineStart < contents.size()) {
+        size_t lineEnd = contents.find('\n', lineStart);
+        if (lineEnd == string_view::npos) {
+            lineEnd = contents.size();
         }
+        string_view line = contents.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
 
+        if (!parseInputLine(line, lineNum == 0, parsedContent.emplace_back())) {
+            throw invalidInput(lineNum);
+        }
         lineNum++;
     }
 
+    if (parsedContent.empty()) {
+        // an empty file has no origin port line
+        throw invalidInput(0);
+    }
+
     return parsedContent;
 }
 
-bool SystemUtils::loadFileToGraphs(const std::string &inputFilename, shared_ptr<ContainersGraph> containersGraph,
-                                   shared_ptr<TimesGraph> timesGraph) {
-    try {
-        auto parsedContent = parseInputFile(inputFilename);
-        auto firstTuple = parsedContent[0];
-        auto firstPort = get<0>(firstTuple);
-        auto firstTime = get<1>(firstTuple);
-
-        // load data to the graphs
-        for (size_t i = 0; i < parsedContent.size(); i++) {
-            auto tuple = parsedContent[i];
-            auto port = get<0>(tuple);
-            auto startTime = get<1>(tuple);
-            auto endTime = get<2>(tuple);
-            auto containers = get<3>(tuple);
-
-            // containers graph
-            containersGraph->addPort(port);
-            if (i > 0) {
-                containersGraph->addSail(firstPort, port, firstTime, startTime, containers);
-            }
+void SystemUtils::collectRowsSails(const vector<tuple<string_view, Date, Date, int>> &parsedContent,
+                                   shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph,
+                                   ContainersSails &containersSails, vector<SailKey> &timesSails) {
+    // intern the ports names of all the rows
+    auto& portRegistry = *timesGraph->getPortRegistry();
+    vector<PortId> portsIds;
+    portsIds.reserve(parsedContent.size());
+    for (const auto& tuple : parsedContent) {
+        portsIds.push_back(portRegistry.intern(get<0>(tuple)));
+    }
 
-            // times graph
-            timesGraph->addPort(port);
-            if (i < parsedContent.size() - 1) {
-                auto nextTuple = parsedContent[i + 1];
-                auto nextPort = get<0>(nextTuple);
-                auto nextStartTime = get<1>(nextTuple);
-                if (i == 0) {
-                    timesGraph->addSail(port, nextPort, startTime, nextStartTime);
-                } else {
-                    timesGraph->addSail(port, nextPort, endTime, nextStartTime);
-                }
-            }
+    auto firstPort = portsIds[0];
+    auto firstTime = get<1>(parsedContent[0]);
+
+    // add the ports to the graphs, and collect the sails
+    for (size_t i = 0; i < parsedContent.size(); i++) {
+        const auto& tuple = parsedContent[i];
+        auto port = portsIds[i];
+        auto startTime = get<1>(tuple);
+        auto endTime = get<2>(tuple);
+        auto containers = get<3>(tuple);
+
+        // containers graph
+        containersGraph->addPort(port);
+        if (i > 0) {
+            containersSails.push_back(firstPort, port, firstTime, startTime, containers);
         }
-        return true;
 
+        // times graph
+        timesGraph->addPort(port);
+        if (i < parsedContent.size() - 1) {
+            const auto& nextTuple = parsedContent[i + 1];
+            auto nextPort = portsIds[i + 1];
+            auto nextStartTime = get<1>(nextTuple);
+            Date sailStartTime = i == 0 ? startTime : endTime;
+            timesSails.push_back({port, nextPort, sailStartTime.toMinutes(), nextStartTime.toMinutes()});
+        }
+    }
+}
+
+void SystemUtils::addRowsToGraphs(const vector<tuple<string_view, Date, Date, int>> &parsedContent,
+                                  shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph) {
+    ContainersSails containersSails;
+    vector<SailKey> timesSails;
+    collectRowsSails(parsedContent, containersGraph, timesGraph, containersSails, timesSails);
+    containersGraph->addSails(containersSails);
+    timesGraph->addSails(timesSails);
+}
+
+bool SystemUtils::loadFileToGraphs(const std::string &inputFilename, shared_ptr<ContainersGraph> containersGraph,
+                                   shared_ptr<TimesGraph> timesGraph, ostream &err) {
+    auto timer = CommandStats::global().time(Commands::LOAD_COMMAND);
+    try {
+        MappedFile inputFile(inputFilename);
+        auto parsedContent = parseInputFile(inputFile, inputFilename);
+        addRowsToGraphs(parsedContent, containersGraph, timesGraph);
+        return true;
     } catch (FileErrorException& e) {
-        cerr << e.what() << endl;
+        CommandStats::global().recordError(CommandError::FILE_ERROR);
+        err << e.what() << endl;
         return false;
     } catch (InvalidInputException& e) {
-        cerr << e.what() << endl;
+        CommandStats::global().recordError(CommandError::INVALID_INPUT);
+        err << e.what() << endl;
         return false;
     }
 }
 
-void SystemUtils::inbound(const std::string &portName, shared_ptr<TimesGraph> timesGraph) {
+bool SystemUtils::loadFilesToGraphs(const vector<string> &inputFilenames, shared_ptr<ContainersGraph> containersGraph,
+                                    shared_ptr<TimesGraph> timesGraph, ThreadPool &threadPool) {
+    auto timer = CommandStats::global().time(Commands::LOAD_COMMAND);
+
+    // parse all the files concurrently
+    vector<future<pair<MappedFile, vector<tuple<string_view, Date, Date, int>>>>> parsedFiles;
+    parsedFiles.reserve(inputFilenames.size());
+    for (const auto& inputFilename : inputFilenames) {
+        parsedFiles.push_back(threadPool.submit([&inputFilename]() {
+            MappedFile inputFile(inputFilename);
+            auto parsedContent = parseInputFile(inputFile, inputFilename);
+            return make_pair(std::move(inputFile), std::move(parsedContent));
+        }));
+    }
+
+    // collect the sails of the files in the given order while the next files are still parsed,
+    // then add all of them at once
+    bool allLoaded = true;
+    ContainersSails containersSails;
+    vector<SailKey> timesSails;
+    for (auto& parsedFile : parsedFiles) {
+        try {
+            auto [inputFile, parsedContent] = parsedFile.get();
+            collectRowsSails(parsedContent, containersGraph, timesGraph, containersSails, timesSails);
+        } catch (FileErrorException& e) {
+            CommandStats::global().recordError(CommandError::FILE_ERROR);
+            cerr << e.what() << endl;
+            allLoaded = false;
+        } catch (InvalidInputException& e) {
+            CommandStats::global().recordError(CommandError::INVALID_INPUT);
+            cerr << e.what() << endl;
+            allLoaded = false;
+        }
+    }
+
+    containersGraph->addSails(containersSails);
+    timesGraph->addSails(timesSails);
+    return allLoaded;
+}
+
+void SystemUtils::usageError(ostream &err) {
+    CommandStats::global().recordError(CommandError::USAGE);
+    err << Commands::USAGE_STRING << endl;
+}
+
+void SystemUtils::inbound(const std::string &portName, shared_ptr<TimesGraph> timesGraph, bool withStats, OutputWriter &out, ostream &err) {
     try {
         auto inboundPorts = timesGraph->inbound(portName);
         if (inboundPorts.empty()) {
-            cout << portName << ": " << "no inbound ports" << endl;
+            out << portName << ": " << "no inbound ports" << '\n';
             return;
         }
         for (const auto& inboundTuple : inboundPorts) {
             const auto& port = get<0>(inboundTuple);
             const auto& time = get<1>(inboundTuple);
-            cout << port->getName() << ", " << time << endl;
+            out << timesGraph->getPortRegistry()->getName(port) << ", " << time;
+            if (withStats) {
+                out << " ";
+                timesGraph->getSails().getStats(get<2>(inboundTuple)).print(out);
+            }
+            out << '\n';
         }
     } catch (PortNotExistsException& e) {
-        cerr << e.what() << endl;
+        CommandStats::global().recordError(CommandError::PORT_NOT_EXISTS);
+        err << e.what() << endl;
     }
 }
 
-void SystemUtils::outbound(const std::string &portName, shared_ptr<TimesGraph> timesGraph) {
+void SystemUtils::outbound(const std::string &portName, shared_ptr<TimesGraph> timesGraph, bool withStats, OutputWriter &out, ostream &err) {
     try {
         auto outboundPorts = timesGraph->outbound(portName);
         if (outboundPorts.empty()) {
-            cout << portName << ": " << "no outbound ports" << endl;
+            out << portName << ": " << "no outbound ports" << '\n';
             return;
         }
         for (const auto& outboundTuple : outboundPorts) {
             const auto& port = get<0>(outboundTuple);
             const auto& time = get<1>(outboundTuple);
-            cout << port->getName() << ", " << time << endl;
+            out << timesGraph->getPortRegistry()->getName(port) << ", " << time;
+            if (withStats) {
+                out << " ";
+                timesGraph->getSails().getStats(get<2>(outboundTuple)).print(out);
+            }
+            out << '\n';
         }
     } catch (PortNotExistsException& e) {
-        cerr << e.what() << endl;
+        CommandStats::global().recordError(CommandError::PORT_NOT_EXISTS);
+        err << e.what() << endl;
     }
 }
 
 void
-SystemUtils::balance(const std::string &portName, shared_ptr<Date> date, shared_ptr<ContainersGraph> containersGraph) {
+SystemUtils::balance(const std::string &portName, Date date, shared_ptr<ContainersGraph> containersGraph, OutputWriter &out,
+                     ostream &err) {
     try {
         int balanceValue = containersGraph->balance(portName, date);
-        cout << balanceValue << endl;
+        out << balanceValue << '\n';
+    } catch (PortNotExistsException& e) {
+        CommandStats::global().recordError(CommandError::PORT_NOT_EXISTS);
+        err << e.what() << endl;
+    } catch (CompactedDateException& e) {
+        CommandStats::global().recordError(CommandError::COMPACTED_DATE);
+        err << e.what() << endl;
+    }
+}
+
+void SystemUtils::route(const std::string &srcPortName, const std::string &destPortName, shared_ptr<TimesGraph> timesGraph,
+                        OutputWriter &out, ostream &err) {
+    try {
+        auto legs = timesGraph->route(srcPortName, destPortName);
+        if (!legs) {
+            out << srcPortName << ": " << "no route to " << destPortName << '\n';
+            return;
+        }
+
+        long long totalTime = 0;
+        for (const auto& leg : *legs) {
+            totalTime += get<2>(leg);
+        }
+        out << srcPortName << " to " << destPortName << ": " << totalTime << " minutes" << '\n';
+
+        const auto& portRegistry = *timesGraph->getPortRegistry();
+        for (const auto& [legSrcPort, legDestPort, time] : *legs) {
+            out << portRegistry.getName(legSrcPort) << " -> " << portRegistry.getName(legDestPort) << ", " << time << '\n';
+        }
     } catch (PortNotExistsException& e) {
-        cerr << e.what() << endl;
+        CommandStats::global().recordError(CommandError::PORT_NOT_EXISTS);
+        err << e.what() << endl;
     }
 }
 
-void SystemUtils::executeCommand(const std::string &command, vector<string> args, shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph) {
+void SystemUtils::earliest(const std::string &srcPortName, const std::string &destPortName, Date date,
+                           shared_ptr<TimesGraph> timesGraph, OutputWriter &out, ostream &err) {
+    try {
+        auto journey = timesGraph->earliestArrival(srcPortName, destPortName, date);
+        if (!journey) {
+            out << srcPortName << ": " << "no journey to " << destPortName << " from " << date << '\n';
+            return;
+        }
+
+        Date arrivalDate = journey->empty() ? date : Date::fromMinutes(journey->back().arrivalMinute);
+        out << srcPortName << " to " << destPortName << ": arrives " << arrivalDate << '\n';
+
+        const auto& portRegistry = *timesGraph->getPortRegistry();
+        for (const auto& leg : *journey) {
+            out << portRegistry.getName(leg.srcPort) << " (" << Date::fromMinutes(leg.departureMinute) << ") -> "
+                << portRegistry.getName(leg.destPort) << " (" << Date::fromMinutes(leg.arrivalMinute) << ")" << '\n';
+        }
+    } catch (PortNotExistsException& e) {
+        CommandStats::global().recordError(CommandError::PORT_NOT_EXISTS);
+        err << e.what() << endl;
+    } catch (CompactedDateException& e) {
+        CommandStats::global().recordError(CommandError::COMPACTED_DATE);
+        err << e.what() << endl;
+    }
+}
+
+void SystemUtils::profile(const std::string &srcPortName, const std::string &destPortName, Date fromDate,
+                          Date toDate, shared_ptr<TimesGraph> timesGraph, OutputWriter &out, ostream &err) {
+    try {
+        auto journeys = timesGraph->profile(srcPortName, destPortName, fromDate, toDate);
+        if (journeys.empty()) {
+            out << srcPortName << ": " << "no journey to " << destPortName << " between " << fromDate << " and "
+                << toDate << '\n';
+            return;
+        }
+
+        out << srcPortName << " to " << destPortName << ":" << '\n';
+        for (const auto& [departureMinute, arrivalMinute] : journeys) {
+            out << "departs " << Date::fromMinutes(departureMinute) << ", arrives " << Date::fromMinutes(arrivalMinute)
+                << '\n';
+        }
+    } catch (PortNotExistsException& e) {
+        CommandStats::global().recordError(CommandError::PORT_NOT_EXISTS);
+        err << e.what() << endl;
+    } catch (CompactedDateException& e) {
+        CommandStats::global().recordError(CommandError::COMPACTED_DATE);
+        err << e.what() << endl;
+    }
+}
+
+void SystemUtils::balances(Date date, shared_ptr<ContainersGraph> containersGraph, OutputWriter &out) {
+    const auto& portRegistry = *containersGraph->getPortRegistry();
+    for (const auto& [port, balanceValue] : containersGraph->balances(date)) {
+        out << portRegistry.getName(port) << ": " << balanceValue << '\n';
+    }
+}
+
+void SystemUtils::top(size_t count, Date date, shared_ptr<ContainersGraph> containersGraph, OutputWriter &out) {
+    const auto& portRegistry = *containersGraph->getPortRegistry();
+    PortsRanking ranking = containersGraph->top(date, count);
+
+    auto printList = [&out, &portRegistry](const string& title, const vector<pair<PortId, int>>& ports) {
+        out << title << ":" << '\n';
+        for (const auto& [port, value] : ports) {
+            out << portRegistry.getName(port) << ": " << value << '\n';
+        }
+    };
+    printList("Highest balance", ranking.highestBalance);
+    printList("Lowest balance", ranking.lowestBalance);
+    printList("Most inbound", ranking.mostInbound);
+    printList("Most outbound", ranking.mostOutbound);
+}
+
+void SystemUtils::executeCommand(const std::string &command, vector<string> args, shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph,
+                                 OutputWriter &out, ostream &err) {
+    auto timer = CommandStats::global().time(command);
     string portName = args[0];
     if (command == Commands::INBOUND_COMMAND) {
-        if (args.size() != 1) {
-            cerr << Commands::USAGE_STRING << endl;
+        if (args.size() > 2 || (args.size() == 2 && args[1] != Commands::STATS_OPTION)) {
+            usageError(err);
             return;
         }
-        inbound(portName, timesGraph);
+        inbound(portName, timesGraph, args.size() == 2, out, err);
     } else if (command == Commands::OUTBOUND_COMMAND) {
-        if (args.size() != 1) {
-            cerr << Commands::USAGE_STRING << endl;
+        if (args.size() > 2 || (args.size() == 2 && args[1] != Commands::STATS_OPTION)) {
+            usageError(err);
             return;
         }
-        outbound(portName, timesGraph);
+        outbound(portName, timesGraph, args.size() == 2, out, err);
     } else if (command == Commands::BALANCE_COMMAND) {
         if (args.size() != 2) {
-            cerr << Commands::USAGE_STRING << endl;
+            usageError(err);
             return;
         }
         string dateStr = args[1];
         try {
-            shared_ptr<Date> date = make_shared<Date>(dateStr);
-            balance(portName, date, containersGraph);
+            Date date(dateStr);
+            balance(portName, date, containersGraph, out, err);
         } catch (DateFormatException& e) {
-            cerr << Commands::USAGE_STRING << endl;
+            usageError(err);
+            return;
+        }
+    } else if (command == Commands::ROUTE_COMMAND) {
+        if (args.size() != 2) {
+            usageError(err);
             return;
         }
+        route(portName, args[1], timesGraph, out, err);
+    } else if (command == Commands::EARLIEST_COMMAND) {
+        if (args.size() != 3) {
+            usageError(err);
+            return;
+        }
+        try {
+            Date date(args[2]);
+            earliest(portName, args[1], date, timesGraph, out, err);
+        } catch (DateFormatException& e) {
+            usageError(err);
+            return;
+        }
+    } else if (command == Commands::PROFILE_COMMAND) {
+        if (args.size() != 4) {
+            usageError(err);
+            return;
+        }
+        try {
+            Date fromDate(args[2]);
+            Date toDate(args[3]);
+            profile(portName, args[1], fromDate, toDate, timesGraph, out, err);
+        } catch (DateFormatException& e) {
+            usageError(err);
+            return;
+        }
+    } else {
+        // invalid command
+        usageError(err);
+        return;
+    }
+}
+
+void SystemUtils::executeNetworkCommand(const std::string &command, vector<string> args, shared_ptr<ContainersGraph> containersGraph,
+                                        OutputWriter &out, ostream &err) {
+    auto timer = CommandStats::global().time(command);
+    if (command == Commands::BALANCES_COMMAND) {
+        if (args.size() != 1) {
+            usageError(err);
+            return;
+        }
+        try {
+            Date date(args[0]);
+            balances(date, containersGraph, out);
+        } catch (DateFormatException& e) {
+            usageError(err);
+            return;
+        } catch (CompactedDateException& e) {
+            CommandStats::global().recordError(CommandError::COMPACTED_DATE);
+            err << e.what() << endl;
+        }
+    } else if (command == Commands::TOP_COMMAND) {
+        if (args.size() != 2) {
+            usageError(err);
+            return;
+        }
+        size_t count = 0;
+        const string& countStr = args[0];
+        auto [end, error] = from_chars(countStr.data(), countStr.data() + countStr.size(), count);
+        if (error != errc() || end != countStr.data() + countStr.size() || count == 0) {
+            usageError(err);
+            return;
+        }
+        try {
+            Date date(args[1]);
+            top(count, date, containersGraph, out);
+        } catch (DateFormatException& e) {
+            usageError(err);
+            return;
+        } catch (CompactedDateException& e) {
+            CommandStats::global().recordError(CommandError::COMPACTED_DATE);
+            err << e.what() << endl;
+        }
     } else {
         // invalid command
-        cerr << Commands::USAGE_STRING << endl;
+        usageError(err);
         return;
     }
 }
 
-void SystemUtils::printGraphs(const std::string &outputFilename, shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph) {
+void SystemUtils::printGraphs(const std::string &outputFilename, shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph,
+                              bool withStats) {
+    auto timer = CommandStats::global().time(Commands::PRINT_COMMAND);
+    lock_guard<mutex> lock(outputFileMutex);
     ofstream outFile(outputFilename);
 
     if (!outFile) {
@@ -240,6 +541,14 @@ void SystemUtils::printGraphs(const std::string &outputFilename, shared_ptr<Cont
         return;
     }
 
-    containersGraph->print(outFile);
-    timesGraph->print(outFile);
+    OutputWriter out(outFile);
+    containersGraph->print(out);
+    timesGraph->print(out, withStats);
 }
+
+void SystemUtils::printStats(shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph, OutputWriter &out) {
+    CommandStats::global().print(out);
+
+    out << "Graphs: " << timesGraph->getPortRegistry()->size() << " ports, " << containersGraph->getSails().size()
+        << " containers edges, " << timesGraph->getSails().size() << " times edges" << '\n';
+}
\ No newline at end of file
@@ -2,8 +2,11 @@
 #define HW2_SYSTEMUTILS_H
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include "ContainersGraph.h"
 #include "TimesGraph.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
 using namespace std;
 
 /**
@@ -11,67 +14,217 @@ using namespace std;
  */
 class SystemUtils {
 private:
+    // serializes the prints, so prints of concurrent clients don't interleave in the output file
+    static mutex outputFileMutex;
+
     /**
      * Check if some port name is valid.
      * @param portName - the name of the port.
      * @return True if the name is valid, otherwise false.
      */
-    static bool isValidPortName(const string& portName);
+    static bool isValidPortName(string_view portName);
+
+    /**
+     * Parse a containers amount.
+     * @param containersStr - the text of the amount, possibly surrounded by whitespaces.
+     * @param containers - the parsed amount.
+     * @return True if the text is a valid non-negative amount, otherwise false.
+     */
+    static bool parseContainers(string_view containersStr, int& containers);
+
+    /**
+     * Parse a mapped input file into tuples represent each file's row.
+     * The rows' port names point into the mapped file, so it must outlive the returned rows.
+     * @param inputFile - the mapped input file to parse.
+     * @param inputFilename - the name of the input file, for error messages.
+     * @throws InvalidInputException - if the input file is in invalid format.
+     * @return vector of tuples each represent a row in the file (portName, startDate, endDate, containers)
+     */
+    static vector<tuple<string_view, Date, Date, int>>
+    parseInputFile(const MappedFile& inputFile, const string& inputFilename);
 
     /**
-     * Parse an input file into tuples represent each file's row.
-     * @param inputFile - the input file to parse.
-     * @return vector of tuples each represent a row in the file (Port, startDate, endDate, containers)
+     * Collect the sails of an input file's parsed rows, and add its ports to the transportation graphs.
+     * @param parsedContent - the rows of the file, as returned from parseInputFile.
+     * @param containersGraph - transportation containers graph.
+     * @param timesGraph - transportation times graph.
+     * @param containersSails - the containers sails of the rows are appended to it, in the order they are added.
+     * @param timesSails - the times sails of the rows are appended to it, in the order they are added.
+     */
+    static void collectRowsSails(const vector<tuple<string_view, Date, Date, int>>& parsedContent,
+                                 shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph,
+                                 ContainersSails& containersSails, vector<SailKey>& timesSails);
+
+    /**
+     * Add the parsed rows of an input file to the transportation graphs, all the sails at once.
+     * @param parsedContent - the rows of the file, as returned from parseInputFile.
+     * @param containersGraph - transportation containers graph.
+     * @param timesGraph - transportation times graph.
      */
-    static vector<tuple<shared_ptr<Port>, shared_ptr<Date>, shared_ptr<Date>, int>>
-    parseInputFile(const string& inputFilename);
+    static void addRowsToGraphs(const vector<tuple<string_view, Date, Date, int>>& parsedContent,
+                                shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph);
 
     /**
      * Print the inbound of some port from the containers graph.
      * @param portName - the name of the port.
      * @param timesGraph - transportation times graph.
+     * @param withStats - print the summary of every edge's sail times too.
+     * @param out - writer to print the result into.
+     * @param err - stream to print the errors into.
      */
-    static void inbound(const string& portName, shared_ptr<TimesGraph> timesGraph);
+    static void inbound(const string& portName, shared_ptr<TimesGraph> timesGraph, bool withStats, OutputWriter& out, ostream& err);
 
     /**
      * Print the outbound of some port from the containers graph.
      * @param portName - the name of the port.
      * @param timesGraph - transportation times graph.
+     * @param withStats - print the summary of every edge's sail times too.
+     * @param out - writer to print the result into.
+     * @param err - stream to print the errors into.
      */
-    static void outbound(const string& portName, shared_ptr<TimesGraph> timesGraph);
+    static void outbound(const string& portName, shared_ptr<TimesGraph> timesGraph, bool withStats, OutputWriter& out, ostream& err);
 
     /**
      * Print the balance value of some port for specific date from the containers graph.
      * @param portName - the name of the port.
      * @param date - the date for the balance value calculation.
      * @param containersGraph - transportation containers graph.
+     * @param out - writer to print the result into.
+     * @param err - stream to print the errors into.
+     */
+    static void balance(const string& portName, Date date, shared_ptr<ContainersGraph> containersGraph, OutputWriter& out, ostream& err);
+
+    /**
+     * Print the fastest route between two ports from the times graph.
+     * @param srcPortName - the name of the route's source port.
+     * @param destPortName - the name of the route's destination port.
+     * @param timesGraph - transportation times graph.
+     * @param out - writer to print the result into.
+     * @param err - stream to print the errors into.
+     */
+    static void route(const string& srcPortName, const string& destPortName, shared_ptr<TimesGraph> timesGraph, OutputWriter& out, ostream& err);
+
+    /**
+     * Print the journey that arrives the earliest to a port, leaving another port at some date.
+     * @param srcPortName - the name of the journey's source port.
+     * @param destPortName - the name of the journey's destination port.
+     * @param date - the earliest date the journey may depart.
+     * @param timesGraph - transportation times graph.
+     * @param out - writer to print the result into.
+     * @param err - stream to print the errors into.
+     */
+    static void earliest(const string& srcPortName, const string& destPortName, Date date, shared_ptr<TimesGraph> timesGraph, OutputWriter& out, ostream& err);
+
+    /**
+     * Print the earliest arrival of every departure date in a window, between two ports.
+     * @param srcPortName - the name of the journeys source port.
+     * @param destPortName - the name of the journeys destination port.
+     * @param fromDate - beginning of the departure window.
+     * @param toDate - end of the departure window.
+     * @param timesGraph - transportation times graph.
+     * @param out - writer to print the result into.
+     * @param err - stream to print the errors into.
+     */
+    static void profile(const string& srcPortName, const string& destPortName, Date fromDate, Date toDate, shared_ptr<TimesGraph> timesGraph, OutputWriter& out, ostream& err);
+
+    /**
+     * Print the containers balance of every port at specific date.
+     * @param date - date of the desire balance values.
+     * @param containersGraph - transportation containers graph.
+     * @param out - writer to print the result into.
+     * @throws CompactedDateException - if the date is before the compaction horizon.
+     */
+    static void balances(Date date, shared_ptr<ContainersGraph> containersGraph, OutputWriter& out);
+
+    /**
+     * Print the top ports at specific date by their balance and their inbound / outbound containers volume.
+     * @param count - the maximal amount of ports to print for every criteria.
+     * @param date - date of the ranking.
+     * @param containersGraph - transportation containers graph.
+     * @param out - writer to print the result into.
+     * @throws CompactedDateException - if the date is before the compaction horizon.
      */
-    static void balance(const string& portName, shared_ptr<Date> date, shared_ptr<ContainersGraph> containersGraph);
+    static void top(size_t count, Date date, shared_ptr<ContainersGraph> containersGraph, OutputWriter& out);
 public:
+    /**
+     * Parse a single line of an input file.
+     * @param line - the line, without its line break.
+     * @param isOriginLine - true for the first line of a file, that has only the origin port and its departure time.
+     * @param row - the parsed (portName, startDate, endDate, containers) row, its port name points into the line.
+     * @return True if the line is valid, otherwise false.
+     */
+    static bool parseInputLine(string_view line, bool isOriginLine, tuple<string_view, Date, Date, int>& row);
+
     /**
      * Load sails data from an input file into the transportation graphs.
      * @param inputFilename - the name of the input file to load its data.
      * @param containersGraph - transportation containers graph.
      * @param timesGraph - transportation times graph.
+     * @param err - stream to print the errors into.
      * @throws FileErrorException - if the input file not found or failed to open / read.
      * @throws InvalidInputException - if the input file is in invalid format.
      * @return True if loaded the file successfully, otherwise false.
      */
-    static bool loadFileToGraphs(const string& inputFilename, shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph);
+    static bool loadFileToGraphs(const string& inputFilename, shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph, ostream& err);
+
+    /**
+     * Load sails data from several input files into the transportation graphs.
+     * The files are parsed concurrently, but added to the graphs in the given order,
+     * so the result is the same as loading them one after the other.
+     * Files that fail to load are reported and skipped.
+     * @param inputFilenames - the names of the input files to load their data.
+     * @param containersGraph - transportation containers graph.
+     * @param timesGraph - transportation times graph.
+     * @param threadPool - pool of threads to parse the files on.
+     * @return True if all the files loaded successfully, otherwise false.
+     */
+    static bool loadFilesToGraphs(const vector<string>& inputFilenames, shared_ptr<ContainersGraph> containersGraph,
+                                  shared_ptr<TimesGraph> timesGraph, ThreadPool& threadPool);
+
+    /**
+     * Print the usage of the system commands, and count it as an error.
+     * @param err - stream to print the usage into.
+     */
+    static void usageError(ostream& err);
 
     /**
      * Execute transportation system command.
      * @param command - command keyword.
      * @param args - command arguments.
      * @param containersGraph - transportation containers graph.
+     * @param timesGraph - transportation times graph.
+     * @param out - writer to print the command's result into.
+     * @param err - stream to print the command's errors into.
+     */
+    static void executeCommand(const string& command, vector<string> args, shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph,
+                               OutputWriter& out, ostream& err);
+
+    /**
+     * Execute transportation system command that refers to the whole network rather than a single port.
+     * @param command - command keyword.
+     * @param args - command arguments.
+     * @param containersGraph - transportation containers graph.
+     * @param out - writer to print the command's result into.
+     * @param err - stream to print the command's errors into.
      */
-    static void executeCommand(const string& command, vector<string> args, shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph);
+    static void executeNetworkCommand(const string& command, vector<string> args, shared_ptr<ContainersGraph> containersGraph,
+                                      OutputWriter& out, ostream& err);
 
     /**
-     * Print the representation of the containers and times graphs into the output file.
+     * Print the representation of the containers and times graphs into the output file, one print at a time.
      * @param outputFilename - the name of the output file.
+     * @param withStats - print the summary of every times graph edge's sail times too.
+     */
+    static void printGraphs(const string& outputFilename, shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph,
+                            bool withStats = false);
+
+    /**
+     * Print the calls count, latency and errors stats of the commands, and the sizes of the graphs.
+     * @param containersGraph - transportation containers graph.
+     * @param timesGraph - transportation times graph.
+     * @param out - writer to print the stats into.
      */
-    static void printGraphs(const string& outputFilename, shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph);
+    static void printStats(shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph, OutputWriter& out);
 };
 
 
@@ -0,0 +1,39 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(size_t threadsCount) {
+    if (threadsCount == 0) {
+        threadsCount = 1;
+    }
+    workers.reserve(threadsCount);
+    for (size_t i = 0; i < threadsCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(tasksMutex);
+        stopping = true;
+    }
+    tasksAvailable.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        function<void()> task;
+        {
+            unique_lock<mutex> lock(tasksMutex);
+            tasksAvailable.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                // stopping and nothing left to do
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef HW2_THREADPOOL_H
+#define HW2_THREADPOOL_H
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+using namespace std;
+
+/**
+ * A class that represent a fixed size pool of worker threads.
+ * Tasks are executed in submission order by the first available worker.
+ */
+class ThreadPool {
+private:
+    vector<thread> workers;
+    queue<function<void()>> tasks;
+    mutex tasksMutex;
+    condition_variable tasksAvailable;
+    bool stopping = false;
+
+    /**
+     * Execute tasks until the pool is stopped.
+     */
+    void workerLoop();
+public:
+    /**
+     * Create a pool and start its workers.
+     * @param threadsCount - amount of worker threads, at least one.
+     */
+    explicit ThreadPool(size_t threadsCount = thread::hardware_concurrency());
+
+    /**
+     * Finish the queued tasks and join the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Queue a task for execution.
+     * @param task - callable without arguments.
+     * @return future of the task's result, rethrows the task's exception on get.
+     */
+    template<typename Task>
+    future<invoke_result_t<Task>> submit(Task task) {
+        auto packagedTask = make_shared<packaged_task<invoke_result_t<Task>()>>(std::move(task));
+        auto result = packagedTask->get_future();
+        {
+            lock_guard<mutex> lock(tasksMutex);
+            tasks.emplace([packagedTask]() { (*packagedTask)(); });
+        }
+        tasksAvailable.notify_one();
+        return result;
+    }
+
+    /**
+     * @return The amount of worker threads.
+     */
+    size_t size() const { return workers.size(); }
+};
+
+
+#endif //HW2_THREADPOOL_H
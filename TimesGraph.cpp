@@ -1,115 +1,285 @@
-#include <fstream>
 #include "TimesGraph.h"
 #include "PortNotExistsException.h"
+#include "CompactedDateException.h"
+#include "RadixSort.h"
+#include "ColumnGrowth.h"
+#include <algorithm>
 
-tuple<shared_ptr<Port>, shared_ptr<Port>, shared_ptr<SailTimesData>>
-TimesGraph::sailExists(shared_ptr<Port> srcPort, shared_ptr<Port> destPort) {
-    for (const auto& sailTuple : sails) {
-        const auto& foundedSrcPort = get<0>(sailTuple);
-        const auto& foundedDestPort = get<1>(sailTuple);
+size_t TimesGraph::sailExists(PortId srcPort, PortId destPort) {
+    auto found = sailsIndex.find(sailKey(srcPort, destPort));
+    if (found == sailsIndex.end()) {
+        // no matching edge found
+        return NO_SAIL;
+    }
+    return found->second;
+}
 
-        bool sameSrc = foundedSrcPort->getName() == srcPort->getName();
-        bool sameDest = foundedDestPort->getName() == destPort->getName();
+PortId TimesGraph::findPortByName(const std::string &portName) const {
+    PortId port = portRegistry->find(portName);
+    if (port == INVALID_PORT_ID || !hasPort(port)) {
+        return INVALID_PORT_ID;
+    }
+    return port;
+}
 
-        // found edge with the same values
-        if (sameSrc && sameDest) {
-            return sailTuple;
-        }
+pair<PortId, PortId> TimesGraph::findJourneyPorts(const std::string &srcPortName, const std::string &destPortName) const {
+    auto srcPort = findPortByName(srcPortName);
+    if (srcPort == INVALID_PORT_ID) {
+        throw PortNotExistsException(srcPortName + " does not exist in the database.\n");
+    }
+    auto destPort = findPortByName(destPortName);
+    if (destPort == INVALID_PORT_ID) {
+        throw PortNotExistsException(destPortName + " does not exist in the database.\n");
     }
+    return {srcPort, destPort};
+}
 
-    // no matching edge found
-    return make_tuple(nullptr, nullptr, nullptr);
+void TimesGraph::checkHorizon(Date date) const {
+    if (date.toMinutes() < horizonMinute) {
+        throw CompactedDateException(date.getAsString() + " is before the compaction horizon "
+                                     + getHorizon().getAsString() + "\n");
+    }
 }
 
-shared_ptr<Port> TimesGraph::findPortByName(const std::string &portName) {
-    for (const auto& port : ports) {
-        if (port->getName() == portName) {
-            return port;
-        }
+void TimesGraph::reservePort(PortId port) {
+    if (port >= ports.size()) {
+        ports.resize(port + 1, false);
+        outgoingSails.resize(port + 1);
+        incomingSails.resize(port + 1);
     }
-    return nullptr;
 }
 
-void TimesGraph::addPort(shared_ptr<Port> port) {
-    this->ports.insert(std::move(port));
+shared_ptr<TimesGraph> TimesGraph::clone(shared_ptr<PortRegistry> portRegistry) const {
+    auto copy = make_shared<TimesGraph>(*this);
+    copy->portRegistry = std::move(portRegistry);
+    return copy;
+}
+
+void TimesGraph::addPort(PortId port) {
+    reservePort(port);
+    ports[port] = true;
 }
 
-void TimesGraph::addSail(shared_ptr<Port> srcPort, shared_ptr<Port> destPort, shared_ptr<Date> startDate,
-                         shared_ptr<Date> endDate) {
-    int sailTime = endDate->minutesSince(startDate);
+void TimesGraph::addSail(PortId srcPort, PortId destPort, Date startDate,
+                         Date endDate) {
+    int sailTime = endDate.minutesSince(startDate);
     int newSailTime;
+    addConnection(srcPort, destPort, startDate.toMinutes(), endDate.toMinutes());
 
-    auto sailExistsTuple = sailExists(srcPort, destPort);
-    const auto& foundedSrcPort = get<0>(sailExistsTuple);
-    const auto& foundedDestPort = get<1>(sailExistsTuple);
-    const auto& foundedSailData = get<2>(sailExistsTuple);
+    size_t foundedSail = sailExists(srcPort, destPort);
 
-    if (!foundedSrcPort && !foundedDestPort && !foundedSailData) {
+    if (foundedSail == NO_SAIL) {
         // the new edge does not exist in the graph
-        shared_ptr<SailTimesData> sailData = make_shared<SailTimesData>(startDate, endDate, sailTime);
-        this->sails.emplace_back(std::move(srcPort), std::move(destPort), sailData);
+        SailTimeStats stats;
+        stats.add(sailTime);
+        insertSail(srcPort, destPort, startDate, endDate, sailTime, stats);
     } else {
         // edge already exists, update the average sail time
-        newSailTime = (foundedSailData->getAverageSailTime() + sailTime) / 2;
-        foundedSailData->setAverageSailTime(newSailTime);
+        newSailTime = (sails.getAverageSailTime(foundedSail) + sailTime) / 2;
+        sails.setAverageSailTime(foundedSail, newSailTime);
+        sails.getStats(foundedSail).add(sailTime);
     }
 }
 
-vector<tuple<shared_ptr<Port>, int>> TimesGraph::outbound(const std::string &portName) {
-    vector<tuple<shared_ptr<Port>, int>> outboundPorts;
-    auto port = findPortByName(portName);
-    if (port == nullptr) {
-        throw PortNotExistsException(portName + " does not exist in the database.\n");
+void TimesGraph::addSails(const vector<SailKey>& newSails) {
+    for (const SailKey& sail : newSails) {
+        addConnection(sail.srcPort, sail.destPort, sail.startMinute, sail.endMinute);
     }
 
-    for (const auto& sailTuple : sails) {
-        const auto& srcPort = get<0>(sailTuple);
-        const auto& destPort = get<1>(sailTuple);
-        const auto& sailData = get<2>(sailTuple);
+    // the sails of an edge end up adjacent and in their order, since the sort is stable
+    auto order = RadixSort::sortIndexes(newSails.size(), 2, [&newSails](uint32_t sail, size_t word) -> uint32_t {
+        return word == 0 ? newSails[sail].srcPort : newSails[sail].destPort;
+    });
+
+    // new edges by the index of their first sail, so they are inserted in the order of their first sails
+    struct NewEdge {
+        int averageSailTime;
+        SailTimeStats stats;
+    };
+    vector<NewEdge> newEdges;
+    vector<size_t> newEdgeOfSail(newSails.size(), NO_SAIL);
+
+    for (size_t groupStart = 0; groupStart < order.size();) {
+        const SailKey& first = newSails[order[groupStart]];
+        size_t groupEnd = groupStart + 1;
+        while (groupEnd < order.size() && newSails[order[groupEnd]].srcPort == first.srcPort
+               && newSails[order[groupEnd]].destPort == first.destPort) {
+            groupEnd++;
+        }
+
+        // fold the sail times in their order, exactly as addSail does one by one
+        size_t foundedSail = sailExists(first.srcPort, first.destPort);
+        size_t next = groupStart;
+        int averageSailTime;
+        SailTimeStats stats;
+        if (foundedSail == NO_SAIL) {
+            averageSailTime = first.endMinute - first.startMinute;
+            stats.add(averageSailTime);
+            next++;
+        } else {
+            averageSailTime = sails.getAverageSailTime(foundedSail);
+            stats = sails.getStats(foundedSail);
+        }
+        for (; next < groupEnd; next++) {
+            const SailKey& sail = newSails[order[next]];
+            int sailTime = sail.endMinute - sail.startMinute;
+            averageSailTime = (averageSailTime + sailTime) / 2;
+            stats.add(sailTime);
+        }
 
-        if (srcPort->getName() == port->getName()) {
-            int sailTime = sailData->getAverageSailTime();
-            outboundPorts.emplace_back(destPort, sailTime);
+        if (foundedSail == NO_SAIL) {
+            newEdgeOfSail[order[groupStart]] = newEdges.size();
+            newEdges.push_back({averageSailTime, stats});
+        } else {
+            sails.setAverageSailTime(foundedSail, averageSailTime);
+            sails.getStats(foundedSail) = stats;
         }
+        groupStart = groupEnd;
     }
 
-    return outboundPorts;
+    sails.reserveMore(newEdges.size());
+    ColumnGrowth::reserveMoreKeys(sailsIndex, newEdges.size());
+    for (size_t sail = 0; sail < newSails.size(); sail++) {
+        if (newEdgeOfSail[sail] == NO_SAIL) {
+            continue;
+        }
+        const SailKey& key = newSails[sail];
+        const NewEdge& edge = newEdges[newEdgeOfSail[sail]];
+        insertSail(key.srcPort, key.destPort, Date::fromMinutes(key.startMinute), Date::fromMinutes(key.endMinute),
+                   edge.averageSailTime, edge.stats);
+    }
+}
+
+void TimesGraph::insertSail(PortId srcPort, PortId destPort, Date startDate, Date endDate, int averageSailTime,
+                            const SailTimeStats& stats) {
+    size_t sailIndex = sails.size();
+    this->sails.push_back(srcPort, destPort, startDate, endDate, averageSailTime, stats);
+    sailsIndex.emplace(sailKey(srcPort, destPort), sailIndex);
+
+    // make sure both ports have adjacency lists
+    reservePort(srcPort);
+    reservePort(destPort);
+    outgoingSails[srcPort].push_back(sailIndex);
+    incomingSails[destPort].push_back(sailIndex);
+}
+
+void TimesGraph::restoreSail(PortId srcPort, PortId destPort, Date startDate, Date endDate, int averageSailTime,
+                             const SailTimeStats& stats) {
+    size_t foundedSail = sailExists(srcPort, destPort);
+    if (foundedSail == NO_SAIL) {
+        insertSail(srcPort, destPort, startDate, endDate, averageSailTime, stats);
+    } else {
+        sails.setAverageSailTime(foundedSail, averageSailTime);
+        sails.getStats(foundedSail) = stats;
+    }
+}
+
+void TimesGraph::addConnection(PortId srcPort, PortId destPort, int departureMinute, int arrivalMinute) {
+    if (departureMinute >= horizonMinute) {
+        timetable.addConnection(srcPort, destPort, departureMinute, arrivalMinute);
+    }
+}
+
+size_t TimesGraph::compactTimetable(Date horizon) {
+    if (horizon.toMinutes() <= horizonMinute) {
+        return 0;
+    }
+    horizonMinute = horizon.toMinutes();
+    return timetable.removeBefore(horizonMinute);
+}
+
+optional<vector<Connection>> TimesGraph::earliestArrival(const std::string &srcPortName, const std::string &destPortName,
+                                                        Date date) {
+    auto [srcPort, destPort] = findJourneyPorts(srcPortName, destPortName);
+    checkHorizon(date);
+    if (timetable.isDirty()) {
+        timetable.flush();
+    }
+    return timetable.earliestArrival(srcPort, destPort, date.toMinutes(), ports.size());
 }
 
-vector<tuple<shared_ptr<Port>, int>> TimesGraph::inbound(const std::string &portName) {
-    vector<tuple<shared_ptr<Port>, int>> inboundPorts;
+vector<pair<int, int>> TimesGraph::profile(const std::string &srcPortName, const std::string &destPortName,
+                                           Date fromDate, Date toDate) {
+    auto [srcPort, destPort] = findJourneyPorts(srcPortName, destPortName);
+    checkHorizon(fromDate);
+    if (timetable.isDirty()) {
+        timetable.flush();
+    }
+    return timetable.profile(srcPort, destPort, fromDate.toMinutes(), toDate.toMinutes(), ports.size());
+}
+
+vector<tuple<PortId, int, size_t>> TimesGraph::outbound(const std::string &portName) {
+    vector<tuple<PortId, int, size_t>> outboundPorts;
     auto port = findPortByName(portName);
-    if (port == nullptr) {
+    if (port == INVALID_PORT_ID) {
         throw PortNotExistsException(portName + " does not exist in the database.\n");
     }
 
-    for (const auto& sailTuple : sails) {
-        const auto& srcPort = get<0>(sailTuple);
-        const auto& destPort = get<1>(sailTuple);
-        const auto& sailData = get<2>(sailTuple);
+    outboundPorts.reserve(outgoingSails[port].size());
+    for (size_t sailIndex : outgoingSails[port]) {
+        outboundPorts.emplace_back(sails.getDestPort(sailIndex), sails.getAverageSailTime(sailIndex), sailIndex);
+    }
 
-        if (destPort->getName() == port->getName()) {
-            int sailTime = sailData->getEndDate()->minutesSince(sailData->getStartDate());
-            inboundPorts.emplace_back(srcPort, sailTime);
-        }
+    return outboundPorts;
+}
+
+vector<tuple<PortId, int, size_t>> TimesGraph::inbound(const std::string &portName) {
+    vector<tuple<PortId, int, size_t>> inboundPorts;
+    auto port = findPortByName(portName);
+    if (port == INVALID_PORT_ID) {
+        throw PortNotExistsException(portName + " does not exist in the database.\n");
+    }
+
+    inboundPorts.reserve(incomingSails[port].size());
+    for (size_t sailIndex : incomingSails[port]) {
+        int sailTime = sails.getEndDate(sailIndex).minutesSince(sails.getStartDate(sailIndex));
+        inboundPorts.emplace_back(sails.getSrcPort(sailIndex), sailTime, sailIndex);
     }
 
     return inboundPorts;
 }
 
-void TimesGraph::print(std::ofstream &outStream) const {
+optional<vector<tuple<PortId, PortId, int>>> TimesGraph::route(const std::string &srcPortName, const std::string &destPortName) const {
+    auto srcPort = findPortByName(srcPortName);
+    if (srcPort == INVALID_PORT_ID) {
+        throw PortNotExistsException(srcPortName + " does not exist in the database.\n");
+    }
+    auto destPort = findPortByName(destPortName);
+    if (destPort == INVALID_PORT_ID) {
+        throw PortNotExistsException(destPortName + " does not exist in the database.\n");
+    }
+
+    // every thread keeps its own search arrays between queries
+    thread_local RouteFinder routeFinder;
+    auto routeSails = routeFinder.findFastestRoute(*this, srcPort, destPort);
+    if (!routeSails) {
+        return nullopt;
+    }
+
+    vector<tuple<PortId, PortId, int>> legs;
+    legs.reserve(routeSails->size());
+    for (size_t sailIndex : *routeSails) {
+        legs.emplace_back(sails.getSrcPort(sailIndex), sails.getDestPort(sailIndex),
+                          max(0, sails.getAverageSailTime(sailIndex)));
+    }
+    return legs;
+}
+
+void TimesGraph::print(OutputWriter &out, bool withStats) const {
     // header
-    outStream << "Times Graph Representation" << std::endl;
+    out << "Times Graph Representation" << '\n';
 
     // sails
-    for (const auto& sailTuple : sails) {
-        const auto& srcPort = get<0>(sailTuple);
-        const auto& destPort = get<1>(sailTuple);
-        const auto& sailData = get<2>(sailTuple);
-
-        outStream << "* Sail from: " << srcPort->getName() << " to " << destPort->getName() << " within " << sailData->getAverageSailTime() << " minutes" << endl;
+    for (size_t sail = 0; sail < sails.size(); sail++) {
+        out << "* Sail from: " << portRegistry->getName(sails.getSrcPort(sail)) << " to "
+            << portRegistry->getName(sails.getDestPort(sail)) << " within " << sails.getAverageSailTime(sail) << " minutes";
+        if (withStats) {
+            out << " ";
+            sails.getStats(sail).print(out);
+        }
+        out << '\n';
     }
 
     // separate break line
-    outStream << std::endl;
+    out << '\n';
 }
@@ -4,42 +4,129 @@
 #include <memory>
 #include <vector>
 #include <set>
+#include <unordered_map>
+#include <optional>
 #include "Port.h"
-#include "SailTimesData.h"
+#include "PortRegistry.h"
+#include "TimesSails.h"
 #include "Date.h"
+#include "OutputWriter.h"
+#include "RouteFinder.h"
+#include "ConnectionTimetable.h"
+#include "SailKey.h"
 using namespace std;
 
 /**
  * A class represent the times graph
+ * Every sail (a leg between consecutive ports of a file) is also kept as a scheduled connection in a timetable,
+ * for time dependent journeys. The connections that depart before the compaction horizon are removed.
  */
 class TimesGraph {
 private:
-    // vertexes
-    set<shared_ptr<Port>> ports;
-    // edges
-    vector<tuple<shared_ptr<Port>, shared_ptr<Port>, shared_ptr<SailTimesData>>> sails;
+    static constexpr size_t NO_SAIL = SIZE_MAX;
+
+    // ports names registry, shared with the containers graph
+    shared_ptr<PortRegistry> portRegistry;
+    // vertexes, indexed by port id
+    vector<bool> ports;
+    // edges, in insertion order
+    TimesSails sails;
+    // adjacency lists of sails indexes, indexed by port id
+    vector<vector<size_t>> outgoingSails;
+    vector<vector<size_t>> incomingSails;
+    // sails indexes by their (source, destination) key
+    unordered_map<uint64_t, size_t> sailsIndex;
+    // every sail as a scheduled connection, for time dependent journeys
+    ConnectionTimetable timetable;
+    // the connections that depart before this minute were removed, so journeys can't depart earlier
+    int horizonMinute = 0;
+
+    /**
+     * Build the index key of a sail.
+     * @param srcPort - sail's source port
+     * @param destPort - sail's destination port
+     * @return Key that uniquely identifies the (source, destination) pair.
+     */
+    static uint64_t sailKey(PortId srcPort, PortId destPort) {
+        return (static_cast<uint64_t>(srcPort) << 32) | destPort;
+    }
 
     /**
      * Check if a sail (graph's edge) is already exists
      * @param srcPort - sail's source port
      * @param destPort - sail's destination port
-     * @return tuple of the sail if found, otherwise nullptr.
+     * @return The sail's index if found, otherwise NO_SAIL.
+     */
+    size_t sailExists(PortId srcPort, PortId destPort);
+
+    /**
+     * Make room for a port in the vertexes and adjacency lists without adding it.
+     * @param port - id of the port
+     */
+    void reservePort(PortId port);
+
+    /**
+     * Add a sail that doesn't exist yet as an edge to the times graph.
+     * @param srcPort - sail's source port
+     * @param destPort - sail's destination port
+     * @param startDate - starting date of the sail
+     * @param endDate - ending date of the sail
+     * @param averageSailTime - the edge's average sail time
+     * @param stats - summary of the edge's sail times
      */
-    tuple<shared_ptr<Port>, shared_ptr<Port>, shared_ptr<SailTimesData>>
-    sailExists(shared_ptr<Port> srcPort, shared_ptr<Port> destPort);
+    void insertSail(PortId srcPort, PortId destPort, Date startDate, Date endDate, int averageSailTime,
+                    const SailTimeStats& stats);
 
     /**
      * Find a port vertex by name.
      * @param portName - the name of the port.
-     * @return Shared pointer to the found port object or nullptr if not found.
+     * @return The id of the found port or INVALID_PORT_ID if not found.
+     */
+    PortId findPortByName(const string& portName) const;
+
+    /**
+     * Add a sail to the timetable, unless it departs before the compaction horizon.
+     * @param srcPort - sail's source port
+     * @param destPort - sail's destination port
+     * @param departureMinute - departure time in minutes since the beginning of the year.
+     * @param arrivalMinute - arrival time in minutes since the beginning of the year.
+     */
+    void addConnection(PortId srcPort, PortId destPort, int departureMinute, int arrivalMinute);
+
+    /**
+     * Find the ids of a journey's ports by name.
+     * @param srcPortName - the name of the journey's source port.
+     * @param destPortName - the name of the journey's destination port.
+     * @throws PortNotExistsException - if there's no port with one of the given names.
+     * @return The ids of the source and destination ports.
+     */
+    pair<PortId, PortId> findJourneyPorts(const string& srcPortName, const string& destPortName) const;
+
+    /**
+     * Check that a journey's departure wasn't compacted.
+     * @param date - the journey's earliest departure.
+     * @throws CompactedDateException - if the date is before the compaction horizon.
      */
-    shared_ptr<Port> findPortByName(const string& portName);
+    void checkHorizon(Date date) const;
 public:
+    /**
+     * Create an empty times graph.
+     * @param portRegistry - ports names registry shared by the system graphs.
+     */
+    explicit TimesGraph(shared_ptr<PortRegistry> portRegistry) : portRegistry(std::move(portRegistry)) {}
+
+    /**
+     * Copy the graph, so the copy can be modified while the graph is being read.
+     * @param portRegistry - ports names registry of the copy, must contain all the ports of the graph.
+     * @return The copy of the graph.
+     */
+    shared_ptr<TimesGraph> clone(shared_ptr<PortRegistry> portRegistry) const;
+
     /**
      * Add a new port as vertex to the times graph.
-     * @param port - port to add
+     * @param port - id of the port to add
      */
-    void addPort(shared_ptr<Port> port);
+    void addPort(PortId port);
 
     /**
     * Add a new sail as an edge to the times graph.
@@ -48,29 +135,146 @@ public:
     * @param startDate - starting date of the sail
     * @param endDate - ending date of the sail
     */
-    void addSail(shared_ptr<Port> srcPort, shared_ptr<Port> destPort, shared_ptr<Date> startDate, shared_ptr<Date> endDate);
+    void addSail(PortId srcPort, PortId destPort, Date startDate, Date endDate);
+
+    /**
+     * Add many sails at once, with the same edges, average sail times and summaries as adding them one by one
+     * in their order. The sails are radix sorted by their ports, so the sails of every edge are folded together
+     * in their order, and the new edges are indexed once.
+     * @param newSails - the sails to add, in the order they would be added one by one.
+     */
+    void addSails(const vector<SailKey>& newSails);
+
+    /**
+     * Add an edge to the times graph with a known average sail time and sail times summary, as saved in a snapshot.
+     * @param srcPort - sail's source port
+     * @param destPort - sail's destination port
+     * @param startDate - starting date of the edge's first sail
+     * @param endDate - ending date of the edge's first sail
+     * @param averageSailTime - the edge's average sail time
+     * @param stats - summary of the edge's sail times
+     */
+    void restoreSail(PortId srcPort, PortId destPort, Date startDate, Date endDate, int averageSailTime,
+                     const SailTimeStats& stats);
+
+    /**
+     * Add a scheduled connection of a sail whose edge is already in the graph, as saved in a snapshot.
+     * @param srcPort - sail's source port
+     * @param destPort - sail's destination port
+     * @param departureMinute - departure time in minutes since the beginning of the year.
+     * @param arrivalMinute - arrival time in minutes since the beginning of the year.
+     */
+    void restoreConnection(PortId srcPort, PortId destPort, int departureMinute, int arrivalMinute) {
+        addConnection(srcPort, destPort, departureMinute, arrivalMinute);
+    }
+
+    /**
+     * Remove the connections that depart before a horizon, so journeys can't depart before it anymore.
+     * The edges and their sail times are kept.
+     * @param horizon - the compaction horizon, ignored if it's not after the current horizon.
+     * @return Amount of the removed connections.
+     */
+    size_t compactTimetable(Date horizon);
+
+    /**
+     * Merge the pending connections into the timetable. Afterward the journey queries don't modify the graph
+     * until the next sail is added, so they can be called from several threads concurrently.
+     */
+    void flushTimetable() { timetable.flush(); }
+
+    /**
+     * Find the journey that arrives the earliest to a port, when the containers are at another port at some date.
+     * @param srcPortName - the name of the journey's source port.
+     * @param destPortName - the name of the journey's destination port.
+     * @param date - the earliest date the journey may depart.
+     * @throws PortNotExistsException - if there's no port with one of the given names.
+     * @throws CompactedDateException - if the date is before the compaction horizon.
+     * @return The journey's legs in sailing order, or nullopt if the destination can't be reached.
+     */
+    optional<vector<Connection>> earliestArrival(const string& srcPortName, const string& destPortName, Date date);
+
+    /**
+     * Find the earliest arrival of every departure date in a window.
+     * @param srcPortName - the name of the journeys source port.
+     * @param destPortName - the name of the journeys destination port.
+     * @param fromDate - beginning of the departure window.
+     * @param toDate - end of the departure window.
+     * @throws PortNotExistsException - if there's no port with one of the given names.
+     * @throws CompactedDateException - if the window begins before the compaction horizon.
+     * @return (departure minute, arrival minute) pairs of the journeys that are not dominated, sorted by departure.
+     */
+    vector<pair<int, int>> profile(const string& srcPortName, const string& destPortName, Date fromDate, Date toDate);
 
     /**
      * Find all the ports that are reachable in a single edge from given port.
      * @param portName - the name of the port.
      * @throws PortNotExistsException - if there's no port with the given name.
-     * @return vector of tuples which contains the reachable ports and their sail time.
+     * @return vector of tuples which contains the reachable ports ids, their sail time and the index of the edge.
      */
-    vector<tuple<shared_ptr<Port>, int>> outbound(const string& portName);
+    vector<tuple<PortId, int, size_t>> outbound(const string& portName);
 
     /**
      * Find all the ports that the given port is reachable from them.
      * @param portName - the name of the port.
      * @throws PortNotExistsException - if there's no port with the given name.
-     * @return vector of tuples which contains the ports can reach the given port and their sail time.
+     * @return vector of tuples which contains the ids of the ports can reach the given port, their sail time
+     * and the index of the edge.
+     */
+    vector<tuple<PortId, int, size_t>> inbound(const string& portName);
+
+    /**
+     * Find the fastest route between two ports, by the average sail times.
+     * @param srcPortName - the name of the route's source port.
+     * @param destPortName - the name of the route's destination port.
+     * @throws PortNotExistsException - if there's no port with one of the given names.
+     * @return vector of tuples which contains the route's legs (source port id, destination port id, sail time)
+     * in sailing order, or nullopt if the destination isn't reachable from the source.
+     */
+    optional<vector<tuple<PortId, PortId, int>>> route(const string& srcPortName, const string& destPortName) const;
+
+    /**
+     * Print representation of the times graph into a given writer.
+     * @param out - reference for the output writer
+     * @param withStats - print the summary of every edge's sail times too
+     */
+    void print(OutputWriter& out, bool withStats = false) const;
+
+    /**
+     * @return The ports names registry used by the graph.
+     */
+    const shared_ptr<PortRegistry>& getPortRegistry() const { return portRegistry; }
+
+    /**
+     * @param port - id of the port.
+     * @return True if the port is a vertex of the graph, otherwise false.
+     */
+    bool hasPort(PortId port) const { return port < ports.size() && ports[port]; }
+
+    /**
+     * @return Upper bound of the ids of the graph's ports.
+     */
+    size_t getPortsCount() const { return ports.size(); }
+
+    /**
+     * @param port - id of the port.
+     * @return Indexes of the sails that depart from the port.
+     */
+    const vector<size_t>& getOutgoingSails(PortId port) const { return outgoingSails[port]; }
+
+    /**
+     * @return The graph's edges, in insertion order.
+     */
+    const TimesSails& getSails() const { return sails; }
+
+    /**
+     * @return The scheduled connections of the sails.
      */
-    vector<tuple<shared_ptr<Port>, int>> inbound(const string& portName);
+    const ConnectionTimetable& getTimetable() const { return timetable; }
 
     /**
-     * Print representation of the times graph into a given stream.
-     * @param outStream - reference for the output file stream
+     * @return The compaction horizon of the timetable, the beginning of the year if it was never compacted.
      */
-    void print(ofstream& outStream) const;
+    Date getHorizon() const { return Date::fromMinutes(horizonMinute); }
 };
 
 
@@ -0,0 +1,71 @@
+#ifndef HW2_TIMESSAILS_H
+#define HW2_TIMESSAILS_H
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include "Port.h"
+#include "Date.h"
+#include "SailTimeStats.h"
+#include "ColumnGrowth.h"
+using namespace std;
+
+/**
+ * A class that stores the times graph's edges as parallel columns, one value per edge in every column.
+ * An edge has a fixed size with no heap objects of its own, so copying the graph copies six flat arrays,
+ * and the route search reads only the destinations and average times columns.
+ */
+class TimesSails {
+private:
+    vector<PortId> srcPorts;
+    vector<PortId> destPorts;
+    // dates of the edge's first sail
+    vector<Date> startDates;
+    vector<Date> endDates;
+    vector<int> averageSailTimes;
+    // summaries of all the edge's sail times
+    vector<SailTimeStats> sailTimesStats;
+public:
+    /**
+     * Add an edge after the stored edges.
+     * @param srcPort - edge's source port
+     * @param destPort - edge's destination port
+     * @param startDate - starting date of the edge's first sail
+     * @param endDate - ending date of the edge's first sail
+     * @param averageSailTime - the edge's average sail time
+     * @param stats - summary of the edge's sail times
+     */
+    void push_back(PortId srcPort, PortId destPort, Date startDate, Date endDate, int averageSailTime,
+                   const SailTimeStats& stats) {
+        srcPorts.push_back(srcPort);
+        destPorts.push_back(destPort);
+        startDates.push_back(startDate);
+        endDates.push_back(endDate);
+        averageSailTimes.push_back(averageSailTime);
+        sailTimesStats.push_back(stats);
+    }
+
+    /**
+     * Make room for more edges, so adding them reallocates the columns at most once.
+     * @param count - amount of edges to make room for, besides the stored ones.
+     */
+    void reserveMore(size_t count) {
+        ColumnGrowth::reserveMore(count, srcPorts, destPorts, startDates, endDates, averageSailTimes, sailTimesStats);
+    }
+
+    /**
+     * @return The amount of stored edges.
+     */
+    size_t size() const { return srcPorts.size(); }
+
+    PortId getSrcPort(size_t sail) const { return srcPorts[sail]; }
+    PortId getDestPort(size_t sail) const { return destPorts[sail]; }
+    Date getStartDate(size_t sail) const { return startDates[sail]; }
+    Date getEndDate(size_t sail) const { return endDates[sail]; }
+    int getAverageSailTime(size_t sail) const { return averageSailTimes[sail]; }
+    void setAverageSailTime(size_t sail, int averageSailTime) { averageSailTimes[sail] = averageSailTime; }
+    const SailTimeStats& getStats(size_t sail) const { return sailTimesStats[sail]; }
+    SailTimeStats& getStats(size_t sail) { return sailTimesStats[sail]; }
+};
+
+
+#endif //HW2_TIMESSAILS_H
@@ -0,0 +1,105 @@
+#include "VoyageDataGenerator.h"
+#include "Date.h"
+#include "FileErrorException.h"
+#include <fstream>
+#include <algorithm>
+
+namespace {
+    const int MINUTES_IN_DAY = 24 * 60;
+    const int MINUTES_IN_YEAR = 365 * MINUTES_IN_DAY;
+    // a single leg never takes more than that, even when there are only a few legs
+    const int MAX_LEG_MINUTES = 3 * MINUTES_IN_DAY;
+    const int MAX_CONTAINERS = 500;
+}
+
+VoyageDataGenerator::VoyageDataGenerator(const VoyageDataConfig &config) : config(config), random(config.seed) {
+    this->config.portsCount = max<size_t>(this->config.portsCount, 1);
+    this->config.dateSpreadDays = clamp(this->config.dateSpreadDays, 1, 364);
+
+    portsNames.reserve(this->config.portsCount);
+    for (size_t i = 0; i < this->config.portsCount; i++) {
+        portsNames.push_back(portName(i));
+    }
+}
+
+string VoyageDataGenerator::portName(size_t index) {
+    // "Port" followed by the index in base 26 letters, 12 letters are enough for any index
+    string name = "Port";
+    do {
+        name += static_cast<char>('a' + index % 26);
+        index /= 26;
+    } while (index > 0);
+    return name;
+}
+
+string VoyageDataGenerator::generateVoyage() {
+    uniform_int_distribution<size_t> portDistribution(0, portsNames.size() - 1);
+    uniform_int_distribution<int> startDistribution(0, config.dateSpreadDays * MINUTES_IN_DAY - 1);
+    uniform_int_distribution<int> containersDistribution(1, MAX_CONTAINERS);
+
+    // spread the legs over the rest of the year, so the voyage never passes its end
+    int minute = startDistribution(random);
+    long long legBudget = (MINUTES_IN_YEAR - 1 - minute) / static_cast<long long>(max<size_t>(config.legsPerFile, 1));
+    int legMinutes = static_cast<int>(min<long long>(legBudget, MAX_LEG_MINUTES));
+    uniform_int_distribution<int> legDistribution(legMinutes / 2, legMinutes);
+
+    char dateText[Date::STRING_LENGTH];
+    string contents;
+    size_t port = portDistribution(random);
+    contents += portsNames[port];
+    contents += ',';
+    contents.append(dateText, Date::fromMinutes(minute).format(dateText));
+    contents += '\n';
+
+    for (size_t leg = 0; leg < config.legsPerFile; leg++) {
+        // never sail from a port to itself
+        size_t nextPort = portDistribution(random);
+        if (nextPort == port && portsNames.size() > 1) {
+            nextPort = (nextPort + 1) % portsNames.size();
+        }
+        port = nextPort;
+
+        // most of the leg is sailing, the rest is the time in the port
+        int legTime = legDistribution(random);
+        int sailTime = legTime - legTime / 5;
+        minute += sailTime;
+        int arrivalMinute = minute;
+        minute += legTime - sailTime;
+        int departureMinute = minute;
+
+        contents += portsNames[port];
+        contents += ',';
+        contents.append(dateText, Date::fromMinutes(arrivalMinute).format(dateText));
+        contents += ',';
+        contents += to_string(containersDistribution(random));
+        contents += ',';
+        contents.append(dateText, Date::fromMinutes(departureMinute).format(dateText));
+        contents += '\n';
+    }
+    return contents;
+}
+
+vector<string> VoyageDataGenerator::generate(const std::string &directory) {
+    uniform_real_distribution<double> duplicateDistribution(0, 1);
+    vector<string> filenames;
+    filenames.reserve(config.filesCount);
+
+    for (size_t i = 0; i < config.filesCount; i++) {
+        if (!filesContents.empty() && duplicateDistribution(random) < config.duplicateRatio) {
+            // repeat a voyage of a previous file
+            uniform_int_distribution<size_t> fileDistribution(0, filesContents.size() - 1);
+            filesContents.push_back(filesContents[fileDistribution(random)]);
+        } else {
+            filesContents.push_back(generateVoyage());
+        }
+
+        string filename = directory + "/voyage" + to_string(i) + ".txt";
+        ofstream file(filename, ios::binary);
+        file << filesContents.back();
+        if (!file) {
+            throw FileErrorException(" ERROR writing the file " + filename + ".");
+        }
+        filenames.push_back(filename);
+    }
+    return filenames;
+}
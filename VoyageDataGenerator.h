@@ -0,0 +1,68 @@
+#ifndef HW2_VOYAGEDATAGENERATOR_H
+#define HW2_VOYAGEDATAGENERATOR_H
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+using namespace std;
+
+/**
+ * The scale of the voyages data to generate.
+ */
+struct VoyageDataConfig {
+    // amount of different ports
+    size_t portsCount = 100;
+    // amount of legs (lines after the origin line) in every file
+    size_t legsPerFile = 100;
+    // amount of input files
+    size_t filesCount = 10;
+    // the voyages start dates are spread over that many days from the beginning of the year
+    int dateSpreadDays = 300;
+    // fraction of the files that repeat the voyage of a previous file
+    double duplicateRatio = 0.1;
+    // seed of the random generator, the same seed generates the same files
+    unsigned int seed = 1;
+};
+
+/**
+ * A class that generates synthetic voyages input files, in the format of the system's input files.
+ */
+class VoyageDataGenerator {
+private:
+    VoyageDataConfig config;
+    mt19937 random;
+    // names of all the ports
+    vector<string> portsNames;
+    // contents of the files generated so far
+    vector<string> filesContents;
+
+    /**
+     * Create a valid port name (letters only, up to 16 characters) from a port index.
+     * @param index - the index of the port.
+     * @return The port's name.
+     */
+    static string portName(size_t index);
+
+    /**
+     * Generate the contents of a single voyage file.
+     * @return The file's contents.
+     */
+    string generateVoyage();
+public:
+    /**
+     * Create a generator of voyages data.
+     * @param config - the scale of the data to generate.
+     */
+    explicit VoyageDataGenerator(const VoyageDataConfig& config);
+
+    /**
+     * Generate the input files.
+     * @param directory - the directory to write the files into, must exist.
+     * @throws FileErrorException - if one of the files can't be written.
+     * @return The paths of the generated files.
+     */
+    vector<string> generate(const string& directory);
+};
+
+
+#endif //HW2_VOYAGEDATAGENERATOR_H
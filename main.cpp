@@ -3,20 +3,62 @@
 #include <sstream>
 #include <algorithm>
 #include <string>
+#include <deque>
+#include <thread>
+#include <condition_variable>
+#include <charconv>
 #include "ContainersGraph.h"
 #include "TimesGraph.h"
 #include "PortNotExistsException.h"
 #include "Commands.h"
 #include "SystemUtils.h"
+#include "GraphStore.h"
+#include "CommandStats.h"
+#include "Snapshot.h"
+#include "FeedFollower.h"
+#include "QueryServer.h"
+#include "FileErrorException.h"
+#include "InvalidInputException.h"
 using namespace std;
 
 // program's constants declarations
 const string WELCOME_PROMPT = "Welcome to Boogie-lever transportation system!";
 const string SUCCESSFUL_UPDATE = "Update was successful.";
+const string SUCCESSFUL_SAVE = "Snapshot was saved.";
+const string COMPACT_RESULT = "Compacted sails: ";
 const string COMMAND_PROMPT = "Please enter command: ";
 const string DEFAULT_OUTPUT_FILENAME = "output.dat";
 const string OUTPUT_FILE_FLAG = "-o";
 const string INPUT_FILE_FLAG = "-i";
+const string QUERIES_FILE_FLAG = "-q";
+const string SNAPSHOT_FILE_FLAG = "-s";
+const string FOLLOW_FILE_FLAG = "-f";
+const string LISTEN_FLAG = "-l";
+const string RETENTION_FLAG = "-r";
+const string USAGE_PROMPT = " [-s <snapshot_file>] -i <input_file1> [input_file2 ...] [-o <outfile>] [-q <queries_file>] [-f <feed_file>] [-l <port|socket_path>] [-r <retention_days>]";
+// time between two reads of a followed feed
+const chrono::milliseconds FOLLOW_INTERVAL(500);
+// a feed update waits at least this many times as long as the previous one took, so copying large graphs
+// takes at most about a tenth of the follow thread's time
+const int FOLLOW_UPDATE_SPACING = 9;
+
+/**
+ * The program's command line arguments.
+ */
+struct ProgramArguments {
+    vector<string> inputFilenames;
+    string outputFilename = DEFAULT_OUTPUT_FILENAME;
+    // empty if the program runs interactively
+    string queriesFilename;
+    // empty if the program doesn't start from a snapshot
+    string snapshotFilename;
+    // empty if the program doesn't follow a feed
+    string followFilename;
+    // loopback port or Unix socket path to serve clients on, empty if the program doesn't run as a server
+    string listenAddress;
+    // days of containers sails to keep behind the latest one, 0 if the graphs are never compacted automatically
+    int retentionDays = 0;
+};
 
 /**
  * Remove leading and trailing whitespace from a given string.
@@ -54,43 +96,507 @@ vector<string> splitCommand(const string& command, char delimiter) {
 }
 
 /**
- * Load transportation data from input file into the system graphs.
+ * Parse the program's command line arguments.
  * @param argc - program's arguments count.
  * @param argv - program's arguments.
+ * @return The parsed arguments.
+ */
+ProgramArguments parseArguments(int argc, char* argv[]) {
+    if (argv[1] != INPUT_FILE_FLAG && argv[1] != SNAPSHOT_FILE_FLAG && argv[1] != FOLLOW_FILE_FLAG) {
+        cerr << "Usage: " << argv[0] << USAGE_PROMPT << endl;
+    }
+
+    ProgramArguments arguments;
+    for (int i = 1; i < argc; i++) {
+        if (argv[i] == INPUT_FILE_FLAG) {
+            continue;
+        }
+        if (argv[i] == OUTPUT_FILE_FLAG && i < argc - 1) {
+            arguments.outputFilename = argv[++i];
+            continue;
+        }
+        if (argv[i] == QUERIES_FILE_FLAG && i < argc - 1) {
+            arguments.queriesFilename = argv[++i];
+            continue;
+        }
+        if (argv[i] == SNAPSHOT_FILE_FLAG && i < argc - 1) {
+            arguments.snapshotFilename = argv[++i];
+            continue;
+        }
+        if (argv[i] == FOLLOW_FILE_FLAG && i < argc - 1) {
+            arguments.followFilename = argv[++i];
+            continue;
+        }
+        if (argv[i] == LISTEN_FLAG && i < argc - 1) {
+            arguments.listenAddress = argv[++i];
+            continue;
+        }
+        if (argv[i] == RETENTION_FLAG && i < argc - 1) {
+            string_view days = argv[++i];
+            auto [end, error] = from_chars(days.data(), days.data() + days.size(), arguments.retentionDays);
+            if (error != errc() || end != days.data() + days.size() || arguments.retentionDays <= 0) {
+                cerr << "Usage: " << argv[0] << USAGE_PROMPT << endl;
+                arguments.retentionDays = 0;
+            }
+            continue;
+        }
+        arguments.inputFilenames.emplace_back(argv[i]);
+    }
+
+    return arguments;
+}
+
+/**
+ * Load transportation data from input file into the system graphs.
+ * @param inputFilenames - the names of the input files.
  * @param containersGraph - transportation containers graph.
  * @param timesGraph - transportation times graph.
- * @return The name of the system's output file.
+ * @param threadPool - pool of threads to parse the input files on.
+ */
+void loadInputFiles(const vector<string>& inputFilenames, shared_ptr<ContainersGraph> containersGraph,
+                    shared_ptr<TimesGraph> timesGraph, ThreadPool& threadPool) {
+    // load input files data
+    SystemUtils::loadFilesToGraphs(inputFilenames, containersGraph, timesGraph, threadPool);
+}
+
+/**
+ * Save the current version of the graphs into a snapshot file.
+ * @param filename - the name of the snapshot file.
+ * @param graphStore - the system graphs.
+ * @param out - stream to print the confirmation into.
+ * @param err - stream to print the errors into.
  */
-string loadInputFiles(int argc, char* argv[], shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph) {
-    if (argv[1] != INPUT_FILE_FLAG) {
-        cerr << "Usage: " << argv[0] << " -i <input_file1> [input_file2 ...] [-o] <outfile>" << endl;
+void saveSnapshot(const string& filename, GraphStore& graphStore, ostream& out, ostream& err) {
+    try {
+        auto timer = CommandStats::global().time(Commands::SAVE_COMMAND);
+        auto version = graphStore.current();
+        Snapshot::save(filename, *version->containersGraph, *version->timesGraph);
+        out << SUCCESSFUL_SAVE << endl;
+    } catch (FileErrorException& e) {
+        CommandStats::global().recordError(CommandError::FILE_ERROR);
+        err << e.what() << endl;
     }
+}
 
-    string outputFilename = DEFAULT_OUTPUT_FILENAME;
-    // load input files data
-    for (int i = 2; i < argc; i++) {
-        if (i > 2 && argv[i] == OUTPUT_FILE_FLAG && i < argc - 1) {
-            outputFilename = argv[i + 1];
-            break;
+/**
+ * Execute a command that takes a file name, given as "load <file>" or "save <file>".
+ * A load runs on the thread pool and builds the new graphs aside, so queries keep reading the current graphs
+ * until the load is published.
+ * @param command - the command line.
+ * @param graphStore - the system graphs.
+ * @param threadPool - pool of threads to run the load on.
+ * @return Future result of a load (true if the file was loaded), or an empty future for any other command.
+ */
+future<bool> executeFileCommand(const string& command, GraphStore& graphStore, ThreadPool& threadPool) {
+    vector<string> tokens = splitCommand(command, ' ');
+    if (tokens.size() != 2) {
+        SystemUtils::usageError(cerr);
+        return {};
+    }
+    string filename = tokens[1];
+
+    if (tokens[0] == Commands::LOAD_COMMAND) {
+        // the turn is taken now, so the loads apply in the order they were typed
+        uint64_t ticket = graphStore.reserveUpdate();
+        return threadPool.submit([&graphStore, filename, ticket]() {
+            return graphStore.update(ticket, [&filename](shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph) {
+                return SystemUtils::loadFileToGraphs(filename, containersGraph, timesGraph, cerr);
+            });
+        });
+    } else if (tokens[0] == Commands::SAVE_COMMAND) {
+        saveSnapshot(filename, graphStore, cout, cerr);
+    } else {
+        SystemUtils::usageError(cerr);
+    }
+    return {};
+}
+
+/**
+ * Check if a token is the keyword of a single port's command, as the second token of "<node>,<keyword>...".
+ * @param token - the trimmed token.
+ * @return True if the token is a port command keyword, otherwise false.
+ */
+bool isPortKeyword(const string& token) {
+    return token == Commands::INBOUND_COMMAND || token == Commands::OUTBOUND_COMMAND
+           || token == Commands::BALANCE_COMMAND || token == Commands::ROUTE_COMMAND
+           || token == Commands::EARLIEST_COMMAND || token == Commands::PROFILE_COMMAND;
+}
+
+/**
+ * Check if a command is the compact command, given as "compact,<date>".
+ * A port may be named compact, so "compact,<keyword>" is a query of that port.
+ * @param command - the command line.
+ * @return True if the command is a compact command, otherwise false.
+ */
+bool isCompactCommand(const string& command) {
+    vector<string> tokens = splitCommand(command, ',');
+    return tokens.size() == 2 && trim(tokens[0]) == Commands::COMPACT_COMMAND && !isPortKeyword(trim(tokens[1]));
+}
+
+/**
+ * Fold the containers sails that end before a horizon into their ports baselines, given as "compact,<date>".
+ * @param command - the command line.
+ * @param graphStore - the system graphs.
+ * @param out - stream to print the amount of the freed sails into.
+ * @param err - stream to print the errors into.
+ */
+void compactGraphs(const string& command, GraphStore& graphStore, ostream& out, ostream& err) {
+    vector<string> tokens = splitCommand(command, ',');
+    Date horizon;
+    if (tokens.size() != 2 || !Date::tryParse(tokens[1], horizon)) {
+        SystemUtils::usageError(err);
+        return;
+    }
+
+    auto timer = CommandStats::global().time(Commands::COMPACT_COMMAND);
+    size_t freedSails = 0;
+    graphStore.update([horizon, &freedSails](shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph>) {
+        // a horizon that didn't move leaves the graphs as they are
+        bool horizonMoved = horizon > containersGraph->getHorizon();
+        freedSails = containersGraph->compact(horizon);
+        return horizonMoved;
+    });
+    out << COMPACT_RESULT << freedSails << endl;
+}
+
+/**
+ * Apply the rows that were appended to a followed feed since the last update, as a new version of the graphs.
+ * Every update copies the whole graphs, so after an update the rows are only read, and they're applied together
+ * once FOLLOW_UPDATE_SPACING times the update's duration passed.
+ * @param feedFollower - the followed feed.
+ * @param graphStore - the system graphs.
+ * @param nextUpdate - the earliest time of the next update, set by every update.
+ */
+void followFeed(FeedFollower& feedFollower, GraphStore& graphStore, chrono::steady_clock::time_point& nextUpdate) {
+    feedFollower.readNewLines();
+    auto updateStart = chrono::steady_clock::now();
+    if (!feedFollower.hasPendingLines() || updateStart < nextUpdate) {
+        return;
+    }
+
+    {
+        auto timer = CommandStats::global().time(CommandStats::FOLLOW_UPDATE);
+        graphStore.update([&feedFollower](shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph) {
+            return feedFollower.applyPendingLines(containersGraph, timesGraph, cerr) > 0;
+        });
+    }
+    auto updateEnd = chrono::steady_clock::now();
+    nextUpdate = updateEnd + (updateEnd - updateStart) * FOLLOW_UPDATE_SPACING;
+}
+
+/**
+ * Report the loads that finished, in the order they were requested.
+ * @param pendingLoads - the loads that were not reported yet, the reported ones are removed.
+ * @param wait - true to wait for all the loads to finish, false to report only up to the first unfinished load.
+ */
+void reportLoads(deque<future<bool>>& pendingLoads, bool wait) {
+    while (!pendingLoads.empty()) {
+        auto& load = pendingLoads.front();
+        if (!wait && load.wait_for(chrono::seconds(0)) != future_status::ready) {
+            return;
+        }
+        if (load.get()) {
+            cout << SUCCESSFUL_UPDATE << endl;
         }
-        string inputFilename = argv[i];
-        SystemUtils::loadFileToGraphs(inputFilename, containersGraph, timesGraph);
+        pendingLoads.pop_front();
     }
+}
 
-    return outputFilename;
+/**
+ * Check if a query refers to the whole network rather than a single port.
+ * A port may be named like a network command keyword, so a query whose second token is a port command keyword
+ * is of that port.
+ * @param tokens - the query's comma separated tokens, at least two.
+ * @return True if the query is a network command, otherwise false.
+ */
+bool isNetworkCommand(const vector<string>& tokens) {
+    string keyword = trim(tokens[0]);
+    return (keyword == Commands::BALANCES_COMMAND || keyword == Commands::TOP_COMMAND) && !isPortKeyword(trim(tokens[1]));
 }
 
 /**
- * Start the interaction with the user through the command line.
+ * Check if a query reads much of the graphs: a network query, or a journey search between ports.
+ * @param command - the query command line.
+ * @return True if the query is a heavy one, otherwise false.
+ */
+bool isHeavyQuery(const string& command) {
+    vector<string> tokens = splitCommand(command, ',');
+    if (tokens.size() < 2) {
+        return false;
+    }
+    string keyword = trim(tokens[1]);
+    return isNetworkCommand(tokens) || keyword == Commands::ROUTE_COMMAND || keyword == Commands::EARLIEST_COMMAND
+           || keyword == Commands::PROFILE_COMMAND;
+}
+
+/**
+ * Check if a command is the print command, given as "print" or "print stats".
+ * @param command - the command line.
+ * @param withStats - set to true if the summaries of the sail times should be printed too.
+ * @return True if the command is a print command, otherwise false.
+ */
+bool isPrintCommand(const string& command, bool& withStats) {
+    vector<string> tokens = splitCommand(command, ' ');
+    if (tokens.empty() || tokens[0] != Commands::PRINT_COMMAND || tokens.size() > 2
+        || (tokens.size() == 2 && tokens[1] != Commands::STATS_OPTION)) {
+        return false;
+    }
+    withStats = tokens.size() == 2;
+    return true;
+}
+
+/**
+ * Execute a query command given as "<node>,<keyword>[,<argument>...]",
+ * or a network query command given as "<keyword>,<argument>[,<argument>...]".
+ * Queries only read the graphs, so several queries can be executed concurrently.
+ * @param command - the query command line.
  * @param containersGraph - transportation containers graph.
  * @param timesGraph - transportation times graph.
+ * @param out - writer to print the query's result into.
+ * @param err - stream to print the query's errors into.
+ */
+void executeQuery(const string& command, shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph,
+                  OutputWriter& out, ostream& err) {
+    vector<string> tokens = splitCommand(command, ',');
+    if (tokens.size() < 2 || tokens.size() > 5) {
+        SystemUtils::usageError(err);
+        return;
+    }
+    string firstToken = trim(tokens[0]);
+    if (isNetworkCommand(tokens)) {
+        vector<string> args;
+        for (size_t i = 1; i < tokens.size(); i++) {
+            args.push_back(trim(tokens[i]));
+        }
+        SystemUtils::executeNetworkCommand(firstToken, args, containersGraph, out, err);
+        return;
+    }
+
+    string portName = firstToken;
+    string commandKeyword = trim(tokens[1]);
+    vector<string> args;
+    args.push_back(portName);
+    for (size_t i = 2; i < tokens.size(); i++) {
+        args.push_back(trim(tokens[i]));
+    }
+    SystemUtils::executeCommand(commandKeyword, args, containersGraph, timesGraph, out, err);
+}
+
+/**
+ * Execute a batch of queries concurrently and print their results in the batch's order.
+ * @param queries - the query command lines.
+ * @param graphStore - the system graphs.
+ * @param threadPool - pool of threads to execute the queries on.
+ */
+void executeQueries(const vector<string>& queries, GraphStore& graphStore, ThreadPool& threadPool) {
+    if (queries.empty()) {
+        return;
+    }
+
+    // the whole batch reads the same version of the graphs
+    auto version = graphStore.current();
+    auto containersGraph = version->containersGraph;
+    auto timesGraph = version->timesGraph;
+
+    // a few chunks per thread, so a slow chunk doesn't hold back the others
+    size_t chunksCount = min(queries.size(), threadPool.size() * 4);
+    size_t chunkSize = (queries.size() + chunksCount - 1) / chunksCount;
+    vector<future<pair<string, string>>> chunksResults;
+    for (size_t chunkStart = 0; chunkStart < queries.size(); chunkStart += chunkSize) {
+        size_t chunkEnd = min(chunkStart + chunkSize, queries.size());
+        chunksResults.push_back(threadPool.submit([&queries, chunkStart, chunkEnd, containersGraph, timesGraph]() {
+            ostringstream outStream;
+            ostringstream err;
+            {
+                OutputWriter out(outStream);
+                for (size_t i = chunkStart; i < chunkEnd; i++) {
+                    executeQuery(queries[i], containersGraph, timesGraph, out, err);
+                }
+            }
+            return make_pair(outStream.str(), err.str());
+        }));
+    }
+
+    for (auto& chunkResult : chunksResults) {
+        auto [out, err] = chunkResult.get();
+        cout << out;
+        cerr << err;
+    }
+    cout.flush();
+}
+
+/**
+ * Execute the commands of a queries file without user interaction.
+ * Consecutive queries run concurrently, while the other commands run alone in their order in the file.
+ * @param queriesFilename - the name of the queries file.
+ * @param graphStore - the system graphs.
  * @param outputFilename - the name of the system's output file.
+ * @param threadPool - pool of threads to execute the queries on.
  */
-void runCommandLine(shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph, const string& outputFilename) {
+void runQueriesFile(const string& queriesFilename, GraphStore& graphStore, const string& outputFilename,
+                    ThreadPool& threadPool) {
+    ifstream queriesFile(queriesFilename);
+    if (!queriesFile) {
+        cerr << "Failed to open queries file: " << queriesFilename << endl;
+        return;
+    }
+
+    vector<string> queries;
+    string command;
+    while (getline(queriesFile, command)) {
+        if (!command.empty() && command.back() == '\r') {
+            command.pop_back();
+        }
+
+        // skip empty lines
+        if (trim(command).empty()) {
+            continue;
+        }
+
+        // compaction modifies the graphs, so it runs alone after the queries before it
+        if (isCompactCommand(command)) {
+            executeQueries(queries, graphStore, threadPool);
+            queries.clear();
+            compactGraphs(command, graphStore, cout, cerr);
+            continue;
+        }
+
+        // queries are collected and executed together
+        if (command.find(',') != std::string::npos) {
+            queries.push_back(command);
+            continue;
+        }
+
+        // any other command has to see the results of the queries before it
+        executeQueries(queries, graphStore, threadPool);
+        queries.clear();
+
+        if (command == Commands::EXIT_COMMAND) {
+            return;
+        }
+
+        bool withStats;
+        if (isPrintCommand(command, withStats)) {
+            auto version = graphStore.current();
+            SystemUtils::printGraphs(outputFilename, version->containersGraph, version->timesGraph, withStats);
+            continue;
+        }
+
+        if (command == Commands::STATS_COMMAND) {
+            auto version = graphStore.current();
+            OutputWriter out(cout);
+            SystemUtils::printStats(version->containersGraph, version->timesGraph, out);
+            continue;
+        }
+
+        // load and save commands, the next commands have to see the loaded file
+        auto load = executeFileCommand(command, graphStore, threadPool);
+        if (load.valid() && load.get()) {
+            cout << SUCCESSFUL_UPDATE << endl;
+        }
+    }
+
+    executeQueries(queries, graphStore, threadPool);
+}
+
+/**
+ * Execute a command of a server client, with the same commands as the command line.
+ * A load, a compaction, a print, a save or a heavy query runs on the thread pool and completes the reply when it's
+ * done, so the other clients aren't held back, any other command completes the reply right away.
+ * @param command - the command line.
+ * @param reply - the response to complete, with the command's output and errors.
+ * @param graphStore - the system graphs.
+ * @param outputFilename - the name of the system's output file.
+ * @param threadPool - pool of threads to run the long commands on.
+ * @return Future of a command that runs on the thread pool, or an empty future for any other command.
+ */
+future<void> executeClientCommand(const string& command, QueryServer::Reply reply, GraphStore& graphStore,
+                                  const string& outputFilename, ThreadPool& threadPool) {
+    ostringstream outStream;
+    ostringstream err;
+    {
+        OutputWriter out(outStream);
+        auto version = graphStore.current();
+        vector<string> tokens = splitCommand(command, ' ');
+        bool withStats;
+
+        if (trim(command).empty()) {
+            SystemUtils::usageError(err);
+        } else if (isPrintCommand(command, withStats)) {
+            return threadPool.submit([version, withStats, outputFilename, reply]() {
+                SystemUtils::printGraphs(outputFilename, version->containersGraph, version->timesGraph, withStats);
+                reply.send("");
+            });
+        } else if (command == Commands::STATS_COMMAND) {
+            SystemUtils::printStats(version->containersGraph, version->timesGraph, out);
+        } else if (isCompactCommand(command)) {
+            return threadPool.submit([&graphStore, command, reply]() {
+                ostringstream compactOut;
+                ostringstream compactErr;
+                compactGraphs(command, graphStore, compactOut, compactErr);
+                reply.send(compactOut.str() + compactErr.str());
+            });
+        } else if (command.find(',') != std::string::npos) {
+            if (!isHeavyQuery(command)) {
+                executeQuery(command, version->containersGraph, version->timesGraph, out, err);
+            } else {
+                // reads the version of the graphs that was current when the query arrived
+                return threadPool.submit([version, command, reply]() {
+                    ostringstream queryOut;
+                    ostringstream queryErr;
+                    {
+                        OutputWriter writer(queryOut);
+                        executeQuery(command, version->containersGraph, version->timesGraph, writer, queryErr);
+                    }
+                    reply.send(queryOut.str() + queryErr.str());
+                });
+            }
+        } else if (tokens.size() == 2 && tokens[0] == Commands::LOAD_COMMAND) {
+            string filename = tokens[1];
+            // the turn is taken now, so the loads apply in the order they arrived
+            uint64_t ticket = graphStore.reserveUpdate();
+            return threadPool.submit([&graphStore, filename, ticket, reply]() {
+                ostringstream loadErr;
+                bool loaded = graphStore.update(ticket, [&filename, &loadErr](shared_ptr<ContainersGraph> containersGraph, shared_ptr<TimesGraph> timesGraph) {
+                    return SystemUtils::loadFileToGraphs(filename, containersGraph, timesGraph, loadErr);
+                });
+                reply.send(loaded ? SUCCESSFUL_UPDATE : loadErr.str());
+            });
+        } else if (tokens.size() == 2 && tokens[0] == Commands::SAVE_COMMAND) {
+            string filename = tokens[1];
+            return threadPool.submit([&graphStore, filename, reply]() {
+                ostringstream saveOut;
+                ostringstream saveErr;
+                saveSnapshot(filename, graphStore, saveOut, saveErr);
+                reply.send(saveOut.str() + saveErr.str());
+            });
+        } else {
+            SystemUtils::usageError(err);
+        }
+    }
+    reply.send(outStream.str() + err.str());
+    return {};
+}
+
+/**
+ * Start the interaction with the user through the command line.
+ * Loads run in the background in the order they were typed, meanwhile the queries use the last published version
+ * of the graphs. A print, a save or a compaction waits for the loads in progress first.
+ * @param graphStore - the system graphs.
+ * @param outputFilename - the name of the system's output file.
+ * @param threadPool - pool of threads to run the loads on.
+ */
+void runCommandLine(GraphStore& graphStore, const string& outputFilename, ThreadPool& threadPool) {
     // print welcome prompt
     cout << WELCOME_PROMPT << endl;
 
+    // queries results are flushed once per command
+    OutputWriter out(cout);
+    deque<future<bool>> pendingLoads;
+
     while (true) {
+        reportLoads(pendingLoads, false);
+
         // print command prompt
         cout << COMMAND_PROMPT << endl;
         string command;
@@ -98,71 +604,153 @@ void runCommandLine(shared_ptr<ContainersGraph> containersGraph, shared_ptr<Time
 
         // handle empty command
         if (command == "") {
-            cerr << Commands::USAGE_STRING << endl;
+            SystemUtils::usageError(cerr);
             continue;
         }
 
-        // exit command
+        // exit command, after the loads in progress are done
         if (command == Commands::EXIT_COMMAND) {
+            reportLoads(pendingLoads, true);
             break;
         }
 
-        // print command
-        if (command == Commands::PRINT_COMMAND) {
-            SystemUtils::printGraphs(outputFilename, containersGraph, timesGraph);
+        // print command, after the loads in progress are done
+        bool withStats;
+        if (isPrintCommand(command, withStats)) {
+            reportLoads(pendingLoads, true);
+            auto version = graphStore.current();
+            SystemUtils::printGraphs(outputFilename, version->containersGraph, version->timesGraph, withStats);
             continue;
         }
 
-        // load command
-        if (command.find(',') == std::string::npos) {
-            vector<string> tokens = splitCommand(command, ' ');
-            if (tokens.size() != 2 || tokens[0] != Commands::LOAD_COMMAND) {
-                cerr << Commands::USAGE_STRING << endl;
-                continue;
-            }
-            string filename = tokens[1];
+        auto version = graphStore.current();
 
-            bool success = SystemUtils::loadFileToGraphs(filename, containersGraph, timesGraph);
-            if (success) {
-                cout << SUCCESSFUL_UPDATE << endl;
-            }
+        // stats command
+        if (command == Commands::STATS_COMMAND) {
+            SystemUtils::printStats(version->containersGraph, version->timesGraph, out);
+            out.flush();
             continue;
         }
 
-        // inbound, outbound, balance commands
-        vector<string> tokens = splitCommand(command, ',');
-        if (tokens.size() != 2 && tokens.size() != 3) {
-            cerr << Commands::USAGE_STRING << endl;
+        // compact command, after the loads in progress are done
+        if (isCompactCommand(command)) {
+            reportLoads(pendingLoads, true);
+            compactGraphs(command, graphStore, cout, cerr);
             continue;
         }
-        string portName = trim(tokens[0]);
-        string commandKeyword = trim(tokens[1]);
-        vector<string> args;
-        args.push_back(portName);
-        if (tokens.size() == 3) {
-            string date = trim(tokens[2]);
-           args.push_back(date);
+
+        // load and save commands, a save after the loads in progress are done
+        if (command.find(',') == std::string::npos) {
+            vector<string> tokens = splitCommand(command, ' ');
+            if (!tokens.empty() && tokens[0] == Commands::SAVE_COMMAND) {
+                reportLoads(pendingLoads, true);
+            }
+            auto load = executeFileCommand(command, graphStore, threadPool);
+            if (load.valid()) {
+                pendingLoads.push_back(std::move(load));
+            }
+            continue;
         }
-        SystemUtils::executeCommand(commandKeyword, args, containersGraph, timesGraph);
+
+        // query commands
+        executeQuery(command, version->containersGraph, version->timesGraph, out, cerr);
+        out.flush();
     }
 }
 
 int main(int argc, char* argv[]) {
     // arguments validation
     if (argc < 3) {
-        cerr << "Usage: " << argv[0] << " -i <input_file1> [input_file2 ...] [-o] <outfile>" << endl;
+        cerr << "Usage: " << argv[0] << USAGE_PROMPT << endl;
         return 1;
     }
 
     // initialize the transportation system graphs
-    shared_ptr<ContainersGraph> containersGraph = make_shared<ContainersGraph>();
-    shared_ptr<TimesGraph> timesGraph = make_shared<TimesGraph>();
+    shared_ptr<PortRegistry> portRegistry = make_shared<PortRegistry>();
+    shared_ptr<ContainersGraph> containersGraph = make_shared<ContainersGraph>(portRegistry);
+    shared_ptr<TimesGraph> timesGraph = make_shared<TimesGraph>(portRegistry);
+
+    // restore the graphs from a snapshot, a snapshot that fails to restore leaves them empty
+    ProgramArguments arguments = parseArguments(argc, argv);
+    containersGraph->setRetention(arguments.retentionDays);
+    if (!arguments.snapshotFilename.empty()) {
+        try {
+            Snapshot::restore(arguments.snapshotFilename, *containersGraph, *timesGraph);
+        } catch (FileErrorException& e) {
+            cerr << e.what() << endl;
+        } catch (InvalidInputException& e) {
+            cerr << e.what() << endl;
+        }
+    }
 
     // load initial data
-    string outputFilename = loadInputFiles(argc, argv, containersGraph, timesGraph);
+    ThreadPool threadPool;
+    loadInputFiles(arguments.inputFilenames, containersGraph, timesGraph, threadPool);
+
+    // from now on the graphs are modified only through the store
+    GraphStore graphStore(containersGraph, timesGraph);
+
+    // open the followed feed and catch up with the rows it already has
+    unique_ptr<FeedFollower> feedFollower;
+    if (!arguments.followFilename.empty()) {
+        try {
+            feedFollower = make_unique<FeedFollower>(arguments.followFilename);
+            auto catchUp = chrono::steady_clock::time_point();
+            followFeed(*feedFollower, graphStore, catchUp);
+        } catch (FileErrorException& e) {
+            CommandStats::global().recordError(CommandError::FILE_ERROR);
+            cerr << e.what() << endl;
+        }
+    }
+
+    // run the queries file without user interaction, over the data the feed had when the program started
+    if (!arguments.queriesFilename.empty()) {
+        runQueriesFile(arguments.queriesFilename, graphStore, arguments.outputFilename, threadPool);
+        return 0;
+    }
+
+    // keep applying the rows appended to the feed in the background, until the program ends
+    jthread followThread;
+    if (feedFollower) {
+        followThread = jthread([&feedFollower, &graphStore](stop_token stopToken) {
+            mutex sleepMutex;
+            condition_variable_any sleepCondition;
+            unique_lock<mutex> lock(sleepMutex);
+            auto nextUpdate = chrono::steady_clock::time_point();
+            // wakes up early only to stop
+            while (!sleepCondition.wait_for(lock, stopToken, FOLLOW_INTERVAL, [&stopToken]() { return stopToken.stop_requested(); })) {
+                followFeed(*feedFollower, graphStore, nextUpdate);
+            }
+        });
+    }
+
+    // serve the clients with the same graphs, until the server is stopped
+    if (!arguments.listenAddress.empty()) {
+        // the commands in progress on the thread pool use the graphs, so the program waits for them before it ends
+        deque<future<void>> pendingCommands;
+        try {
+            QueryServer server(arguments.listenAddress, [&](const string& command, QueryServer::Reply reply) {
+                auto pending = executeClientCommand(command, std::move(reply), graphStore, arguments.outputFilename, threadPool);
+                while (!pendingCommands.empty() && pendingCommands.front().wait_for(chrono::seconds(0)) == future_status::ready) {
+                    pendingCommands.pop_front();
+                }
+                if (pending.valid()) {
+                    pendingCommands.push_back(std::move(pending));
+                }
+            });
+            server.run();
+        } catch (FileErrorException& e) {
+            cerr << e.what() << endl;
+            return 1;
+        }
+        for (auto& pending : pendingCommands) {
+            pending.wait();
+        }
+        return 0;
+    }
 
     // start user interaction
-    runCommandLine(containersGraph, timesGraph, outputFilename);
+    runCommandLine(graphStore, arguments.outputFilename, threadPool);
 
     return 0;
 }
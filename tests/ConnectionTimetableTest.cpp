@@ -0,0 +1,106 @@
+#include "../ConnectionTimetable.h"
+#include <cstdlib>
+
+namespace {
+    const PortId HAIFA = 0;
+    const PortId ASHDOD = 1;
+    const PortId EILAT = 2;
+    const size_t PORTS_COUNT = 3;
+
+    int failures = 0;
+
+    /**
+     * Report a failed check.
+     * @param passed - result of the check.
+     * @param name - name of the check, printed if it failed.
+     */
+    void check(bool passed, const string& name) {
+        if (!passed) {
+            cerr << "FAILED: " << name << endl;
+            failures++;
+        }
+    }
+
+    /**
+     * A journey that departs after the window arrives as early as the ones in the window,
+     * it must not hide them.
+     */
+    void testLaterJourneyDoesNotHideWindow() {
+        ConnectionTimetable timetable;
+        timetable.addConnection(HAIFA, ASHDOD, 600, 1080);
+        timetable.addConnection(HAIFA, ASHDOD, 720, 1080);
+        timetable.flush();
+
+        auto journeys = timetable.profile(HAIFA, ASHDOD, 540, 660, PORTS_COUNT);
+        check(journeys == vector<pair<int, int>>{{600, 1080}}, "later journey does not hide the window");
+
+        auto earliest = timetable.earliestArrival(HAIFA, ASHDOD, 540, PORTS_COUNT);
+        check(earliest && earliest->size() == 1 && earliest->front().departureMinute == 600,
+              "earliest arrival agrees with the profile");
+
+        check(timetable.profile(HAIFA, ASHDOD, 540, 720, PORTS_COUNT) == vector<pair<int, int>>{{720, 1080}},
+              "a journey in the window hides the earlier one");
+    }
+
+    /**
+     * Journeys that change ships on the way are still found when departing after the window would be better.
+     */
+    void testTransferInWindow() {
+        ConnectionTimetable timetable;
+        timetable.addConnection(HAIFA, EILAT, 600, 700);
+        timetable.addConnection(EILAT, ASHDOD, 800, 900);
+        timetable.addConnection(HAIFA, ASHDOD, 1000, 1050);
+        timetable.addConnection(HAIFA, ASHDOD, 650, 1200);
+        timetable.flush();
+
+        auto journeys = timetable.profile(HAIFA, ASHDOD, 0, 660, PORTS_COUNT);
+        check(journeys == vector<pair<int, int>>{{600, 900}, {650, 1200}}, "transfer journey in the window");
+        check(timetable.profile(HAIFA, ASHDOD, 700, 900, PORTS_COUNT).empty(), "no departure in the window");
+    }
+
+    /**
+     * The legs of a file's voyage connect consecutive ports, so a journey may board at any port of the voyage,
+     * not only at its origin.
+     */
+    void testBoardAtIntermediatePort() {
+        ConnectionTimetable timetable;
+        // Haifa 01/01 08:00, Ashdod 01/01 12:00 - 20:00, Eilat 02/01 08:00
+        timetable.addConnection(HAIFA, ASHDOD, 480, 720);
+        timetable.addConnection(ASHDOD, EILAT, 1200, 1920);
+        timetable.flush();
+
+        auto earliest = timetable.earliestArrival(ASHDOD, EILAT, 780, PORTS_COUNT);
+        check(earliest && earliest->size() == 1 && earliest->front().departureMinute == 1200
+              && earliest->front().arrivalMinute == 1920, "earliest arrival boards at an intermediate port");
+        check(timetable.profile(ASHDOD, EILAT, 0, 1380, PORTS_COUNT) == vector<pair<int, int>>{{1200, 1920}},
+              "profile boards at an intermediate port");
+
+        auto whole = timetable.earliestArrival(HAIFA, EILAT, 0, PORTS_COUNT);
+        check(whole && whole->size() == 2 && whole->back().arrivalMinute == 1920, "the voyage's legs chain");
+    }
+
+    /**
+     * The same leg loaded again is kept once, and compaction drops only the legs that depart before the horizon.
+     */
+    void testDuplicateAndRemovedLegs() {
+        ConnectionTimetable timetable;
+        timetable.addConnection(HAIFA, ASHDOD, 480, 720);
+        timetable.addConnection(ASHDOD, EILAT, 1200, 1920);
+        timetable.flush();
+        timetable.addConnection(ASHDOD, EILAT, 1200, 1920);
+        timetable.flush();
+        check(timetable.getConnections().size() == 2, "a duplicated leg is kept once");
+
+        check(timetable.removeBefore(600) == 1, "compaction removes the legs before the horizon");
+        check(timetable.earliestArrival(ASHDOD, EILAT, 780, PORTS_COUNT).has_value(),
+              "the legs after the horizon are kept");
+    }
+}
+
+int main() {
+    testLaterJourneyDoesNotHideWindow();
+    testTransferInWindow();
+    testBoardAtIntermediatePort();
+    testDuplicateAndRemovedLegs();
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,64 @@
+#include "../SystemUtils.h"
+#include <cstdlib>
+
+namespace {
+    int failures = 0;
+
+    /**
+     * Report a failed check.
+     * @param passed - result of the check.
+     * @param name - name of the check, printed if it failed.
+     */
+    void check(bool passed, const string& name) {
+        if (!passed) {
+            cerr << "FAILED: " << name << endl;
+            failures++;
+        }
+    }
+
+    /**
+     * Parse a port line of an input file.
+     * @param line - the line.
+     * @param containers - the parsed containers amount.
+     * @return True if the line is valid, otherwise false.
+     */
+    bool parsePortLine(string_view line, int& containers) {
+        tuple<string_view, Date, Date, int> row;
+        if (!SystemUtils::parseInputLine(line, false, row)) {
+            return false;
+        }
+        containers = get<3>(row);
+        return true;
+    }
+
+    /**
+     * Whitespaces around the containers amount are accepted, as they were before the amount was parsed in place.
+     */
+    void testContainersWhitespaces() {
+        int containers = 0;
+        check(parsePortLine("Ashdod,01/01 12:00,50,01/01 20:00", containers) && containers == 50, "plain amount");
+        check(parsePortLine("Ashdod,01/01 12:00, 50,01/01 20:00", containers) && containers == 50,
+              "leading whitespace");
+        check(parsePortLine("Ashdod,01/01 12:00,50 ,01/01 20:00", containers) && containers == 50,
+              "trailing whitespace");
+        check(parsePortLine("Ashdod,01/01 12:00,\t50\t,01/01 20:00", containers) && containers == 50,
+              "surrounding tabs");
+    }
+
+    /**
+     * An amount that isn't a single non-negative number is rejected.
+     */
+    void testInvalidContainers() {
+        int containers = 0;
+        check(!parsePortLine("Ashdod,01/01 12:00,5 0,01/01 20:00", containers), "whitespace inside the amount");
+        check(!parsePortLine("Ashdod,01/01 12:00, ,01/01 20:00", containers), "whitespace only");
+        check(!parsePortLine("Ashdod,01/01 12:00,-5,01/01 20:00", containers), "negative amount");
+        check(!parsePortLine("Ashdod,01/01 12:00,50x,01/01 20:00", containers), "trailing characters");
+    }
+}
+
+int main() {
+    testContainersWhitespaces();
+    testInvalidContainers();
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}